@@ -1,11 +1,42 @@
 #include <benchmark/benchmark.h>
+#include <chrono>
+#include <coroutine>
+#include <future>
+#include <string>
 #include <vector>
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <utility>
+#include <sys/resource.h>
+#if defined(ARENA_BENCHMARK_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#endif
+#if defined(ARENA_BENCHMARK_MIMALLOC)
+#include <mimalloc.h>
+#endif
 #include "../include/arena.h"
+#include "../include/concurrent_arena.h"
+#include "../include/mmap_block_source.h"
+#include "../include/block_cache.h"
+#include "../include/arena_vector.h"
+#include "../include/pool_arena.h"
+#include "../include/arena_memory_resource.h"
+#include "../include/mapped_arena.h"
+#include "../include/arena_string.h"
+#include "../include/arena_hash_map.h"
+#include "../include/arena_coroutine.h"
+#include "../include/object_arena.h"
 
 constexpr int64_t BENCHMARK_RANGE_START = 1<<10;
 constexpr int64_t BENCHMARK_RANGE_END = 1<<12;
+constexpr int64_t BENCHMARK_LARGE_RANGE_END = 1<<24;
+constexpr int64_t BENCHMARK_RANGE_MULTIPLIER = 8;
 
 static void benchmark_vector_malloc(benchmark::State& state) {
     const size_t n = state.range(0);
@@ -42,8 +73,46 @@ static void benchmark_vector_arena(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations() * n);
 }
 
+static void benchmark_vector_arena_block_cache(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        ArenaV2 arena(ArenaOptions{.block_size = 8192, .source = BlockCache::instance()});
+        std::vector<int, ArenaAllocator<int>> vec{ArenaAllocator<int>(arena)};
+
+        for (size_t i = 0; i < n; ++i) {
+            vec.push_back(static_cast<int>(i));
+        }
+
+        benchmark::DoNotOptimize(vec.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void benchmark_arena_vector(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        ArenaV2 arena(8192);
+        ArenaVector<int> vec(arena);
+
+        for (size_t i = 0; i < n; ++i) {
+            vec.push_back(static_cast<int>(i));
+        }
+
+        benchmark::DoNotOptimize(vec.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
 BENCHMARK(benchmark_vector_malloc)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
 BENCHMARK(benchmark_vector_arena)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_vector_arena_block_cache)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_arena_vector)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
 
 static void benchmark_list_malloc(benchmark::State& state) {
     const size_t n = state.range(0);
@@ -118,8 +187,110 @@ static void benchmark_unordered_map_arena(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations() * n);
 }
 
+static void benchmark_arena_hash_map(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        ArenaV2 arena(65536);
+        ArenaHashMap<int, int> map(arena);
+
+        for (size_t i = 0; i < n; ++i) {
+            map[static_cast<int>(i)] = static_cast<int>(i * 2);
+        }
+
+        benchmark::DoNotOptimize(map.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
 BENCHMARK(benchmark_unordered_map_malloc)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
 BENCHMARK(benchmark_unordered_map_arena)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_arena_hash_map)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+
+using ArenaUnorderedMap = std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, ArenaAllocator<std::pair<const int, int>>>;
+
+template<typename Map>
+static Map make_map(ArenaV2& arena) {
+    if constexpr (std::is_same_v<Map, ArenaUnorderedMap>) {
+        return Map(10, std::hash<int>(), std::equal_to<int>(), ArenaAllocator<std::pair<const int, int>>(arena));
+    } else {
+        return Map(arena);
+    }
+}
+
+/**
+ * `n` pseudo-random keys, so identity-hashed buckets get none of the locality sequential keys give them.
+ */
+static std::vector<int> make_random_keys(const size_t n) {
+    std::vector<int> keys(n);
+    uint32_t x = 12345;
+    for (int& key : keys) {
+        x = x * 1664525u + 1013904223u;
+        key = static_cast<int>(x);
+    }
+    return keys;
+}
+
+/**
+ * Lookups of `n` present and `n` absent random keys, interleaved, in a map of `n` elements built before the timed loop.
+ */
+template<typename Map>
+static void run_map_lookups(benchmark::State& state, Map& map) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::vector<int> keys = make_random_keys(2 * n);
+    for (size_t i = 0; i < 2 * n; i += 2) {
+        map[keys[i]] = static_cast<int>(i);
+    }
+
+    for (auto _ : state) {
+        int64_t hits = 0;
+        for (const int key : keys) {
+            hits += map.find(key) != map.end();
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2 * n);
+}
+
+static void benchmark_lookup_unordered_map_arena(benchmark::State& state) {
+    ArenaV2 arena(65536);
+    auto map = make_map<ArenaUnorderedMap>(arena);
+    run_map_lookups(state, map);
+}
+
+static void benchmark_lookup_arena_hash_map(benchmark::State& state) {
+    ArenaV2 arena(65536);
+    ArenaHashMap<int, int> map(arena);
+    run_map_lookups(state, map);
+}
+
+template<typename Map>
+static void benchmark_random_inserts(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const std::vector<int> keys = make_random_keys(n);
+
+    for (auto _ : state) {
+        ArenaV2 arena(65536);
+        Map map = make_map<Map>(arena);
+        for (const int key : keys) {
+            map[key] = key;
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(benchmark_random_inserts<ArenaUnorderedMap>)->Name("benchmark_random_inserts_unordered_map_arena")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 20);
+BENCHMARK(benchmark_random_inserts<ArenaHashMap<int, int>>)->Name("benchmark_random_inserts_arena_hash_map")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 20);
+
+BENCHMARK(benchmark_lookup_unordered_map_arena)->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 20);
+BENCHMARK(benchmark_lookup_arena_hash_map)->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 20);
 
 static void benchmark_map_malloc(benchmark::State& state) {
     const size_t n = state.range(0);
@@ -159,4 +330,994 @@ static void benchmark_map_arena(benchmark::State& state) {
 BENCHMARK(benchmark_map_malloc)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
 BENCHMARK(benchmark_map_arena)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
 
+// a fixed-size window of live entries, erasing the oldest on every insert.
+static void benchmark_map_churn_arena(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        ArenaV2 arena(65536);
+        std::map<int, int, std::less<int>, ArenaAllocator<std::pair<const int, int>>> map{std::less<int>(),ArenaAllocator<std::pair<const int, int>>(arena)};
+
+        for (size_t i = 0; i < 8 * n; ++i) {
+            if (i >= n) map.erase(static_cast<int>(i - n));
+            map[static_cast<int>(i)] = static_cast<int>(i);
+        }
+
+        benchmark::DoNotOptimize(map.size());
+        state.counters["arena_bytes"] = static_cast<double>(arena.get_arena_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 8 * n);
+}
+
+static void benchmark_map_churn_pool_arena(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        PoolArena pool(65536);
+        std::map<int, int, std::less<int>, PoolArenaAllocator<std::pair<const int, int>>> map{std::less<int>(),PoolArenaAllocator<std::pair<const int, int>>(pool)};
+
+        for (size_t i = 0; i < 8 * n; ++i) {
+            if (i >= n) map.erase(static_cast<int>(i - n));
+            map[static_cast<int>(i)] = static_cast<int>(i);
+        }
+
+        benchmark::DoNotOptimize(map.size());
+        state.counters["arena_bytes"] = static_cast<double>(pool.get_arena().get_arena_size());
+    }
+
+    state.SetItemsProcessed(state.iterations() * 8 * n);
+}
+
+BENCHMARK(benchmark_map_churn_arena)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_map_churn_pool_arena)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+
+static void benchmark_pmr_vector_monotonic(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        std::pmr::monotonic_buffer_resource resource(8192);
+        std::pmr::vector<int> vec(&resource);
+
+        for (size_t i = 0; i < n; ++i) {
+            vec.push_back(static_cast<int>(i));
+        }
+
+        benchmark::DoNotOptimize(vec.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void benchmark_pmr_vector_arena(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        ArenaV2 arena(8192);
+        ArenaMemoryResource resource(arena);
+        std::pmr::vector<int> vec(&resource);
+
+        for (size_t i = 0; i < n; ++i) {
+            vec.push_back(static_cast<int>(i));
+        }
+
+        benchmark::DoNotOptimize(vec.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void benchmark_pmr_map_monotonic(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        std::pmr::monotonic_buffer_resource resource(65536);
+        std::pmr::map<int, int> map(&resource);
+
+        for (size_t i = 0; i < n; ++i) {
+            map[static_cast<int>(i)] = static_cast<int>(i * 2);
+        }
+
+        benchmark::DoNotOptimize(map.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void benchmark_pmr_map_arena(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        ArenaV2 arena(65536);
+        ArenaMemoryResource resource(arena);
+        std::pmr::map<int, int> map(&resource);
+
+        for (size_t i = 0; i < n; ++i) {
+            map[static_cast<int>(i)] = static_cast<int>(i * 2);
+        }
+
+        benchmark::DoNotOptimize(map.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(benchmark_pmr_vector_monotonic)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_pmr_vector_arena)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_pmr_map_monotonic)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_pmr_map_arena)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+
+struct BenchmarkNode {
+    int64_t value;
+    BenchmarkNode* next;
+
+    BenchmarkNode(const int64_t value, BenchmarkNode* next) : value(value), next(next) {}
+    ~BenchmarkNode() { benchmark::DoNotOptimize(value); }
+};
+
+template<typename Create>
+static void run_create_and_clear(benchmark::State& state, ArenaV2& arena, Create create) {
+    const int64_t n = state.range(0);
+
+    for (auto _ : state) {
+        BenchmarkNode* head = nullptr;
+        for (int64_t i = 0; i < n; ++i) {
+            head = create(i, head);
+        }
+        benchmark::DoNotOptimize(head);
+        arena.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void benchmark_clear_registered_destructors(benchmark::State& state) {
+    ArenaV2 arena(1 << 20);
+    run_create_and_clear(state, arena, [&](const int64_t i, BenchmarkNode* next) {
+        return arena.create<BenchmarkNode>(i, next);
+    });
+}
+
+static void benchmark_clear_create_no_dtor(benchmark::State& state) {
+    ArenaV2 arena(1 << 20);
+    run_create_and_clear(state, arena, [&](const int64_t i, BenchmarkNode* next) {
+        return arena.create_no_dtor<BenchmarkNode>(i, next);
+    });
+}
+
+static void benchmark_clear_leak_destructors(benchmark::State& state) {
+    ArenaV2 arena(ArenaOptions{.block_size = 1 << 20, .leak_destructors = true});
+    run_create_and_clear(state, arena, [&](const int64_t i, BenchmarkNode* next) {
+        return arena.create<BenchmarkNode>(i, next);
+    });
+}
+
+BENCHMARK(benchmark_clear_registered_destructors)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_clear_create_no_dtor)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_clear_leak_destructors)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+
+template<int Tag>
+struct TeardownNode {
+    int64_t value;
+
+    explicit TeardownNode(const int64_t value) : value(value) {}
+    ~TeardownNode() { benchmark::DoNotOptimize(value); }
+};
+
+/**
+ * Times only `clear()` of an arena holding `n` objects of three types,
+ * created in runs of `state.range(1)` objects per type.
+ */
+static void benchmark_teardown(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    const int64_t run = state.range(1);
+    ArenaV2 arena(1 << 20);
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            switch (i / run % 3) {
+                case 0: arena.create<TeardownNode<0>>(i); break;
+                case 1: arena.create<TeardownNode<1>>(i); break;
+                default: arena.create<TeardownNode<2>>(i); break;
+            }
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        arena.clear();
+        const auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(benchmark_teardown)
+    ->ArgsProduct({{BENCHMARK_RANGE_START, BENCHMARK_RANGE_END, 1 << 16}, {1, 64}})
+    ->UseManualTime();
+
+/**
+ * Times `clear()`, `clear_parallel()` or `clear_async()` of an arena holding `state.range(0)` strings.
+ */
+template<int Mode>
+static void benchmark_clear_mode(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 arena(1 << 20, ArenaGrowthPolicy::geometric(2.0, 1 << 26));
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            arena.create<std::string>(64, 'x');
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        if constexpr (Mode == 0) {
+            arena.clear();
+        } else if constexpr (Mode == 1) {
+            arena.clear_parallel();
+        } else {
+            std::future<void> reclaimed = arena.clear_async();
+            state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            reclaimed.get();
+            continue;
+        }
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(benchmark_clear_mode<0>)->Name("benchmark_clear_serial")->Arg(1 << 20)->Iterations(8)->UseManualTime();
+BENCHMARK(benchmark_clear_mode<1>)->Name("benchmark_clear_parallel")->Arg(1 << 20)->Iterations(8)->UseManualTime();
+BENCHMARK(benchmark_clear_mode<2>)->Name("benchmark_clear_async")->Arg(1 << 20)->Iterations(8)->UseManualTime();
+
+/**
+ * Request-scoped arena reused across iterations: allocate `state.range(0)` mixed-size objects, then clear.
+ */
+static void run_request_cycles(benchmark::State& state, ArenaV2& arena) {
+    const int64_t n = state.range(0);
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            void* p = arena.allocate_raw(16 + static_cast<size_t>(i % 7) * 24, 8);
+            benchmark::DoNotOptimize(p);
+        }
+        arena.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["blocks"] = static_cast<double>(arena.get_number_of_allocated_blocks());
+}
+
+static void benchmark_request_cycle_fixed(benchmark::State& state) {
+    ArenaV2 arena(8192);
+    run_request_cycles(state, arena);
+}
+
+static void benchmark_request_cycle_adaptive(benchmark::State& state) {
+    ArenaV2 arena(ArenaOptions{.block_size = 8192, .adaptive = {.enabled = true}});
+    run_request_cycles(state, arena);
+}
+
+BENCHMARK(benchmark_request_cycle_fixed)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_request_cycle_adaptive)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+
+/**
+ * Stream of interleaved char/double/int/pointer-sized requests, the pattern that keeps misaligning the bump pointer.
+ */
+static void benchmark_mixed_alignment_raw(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 arena(1 << 20);
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(arena.allocate_raw(1, alignof(char)));
+            benchmark::DoNotOptimize(arena.allocate_raw(sizeof(double), alignof(double)));
+            benchmark::DoNotOptimize(arena.allocate_raw(3, alignof(char)));
+            benchmark::DoNotOptimize(arena.allocate_raw(sizeof(int), alignof(int)));
+        }
+        arena.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n * 4);
+}
+
+static void benchmark_mixed_alignment_typed(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 arena(1 << 20);
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(arena.allocate<char>());
+            benchmark::DoNotOptimize(arena.allocate<double>());
+            benchmark::DoNotOptimize(arena.allocate<char>(3));
+            benchmark::DoNotOptimize(arena.allocate<int>());
+        }
+        arena.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n * 4);
+}
+
+/**
+ * Runtime alignments the compiler cannot fold, exercising the fused align-and-compare sequence itself.
+ */
+static void benchmark_mixed_alignment_runtime(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 arena(1 << 20);
+    size_t aligns[4] = {1, 8, 2, 16};
+    benchmark::DoNotOptimize(aligns);
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(arena.allocate_raw(5, aligns[i & 3]));
+        }
+        arena.clear();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(benchmark_mixed_alignment_raw)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_mixed_alignment_typed)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+BENCHMARK(benchmark_mixed_alignment_runtime)->Range(BENCHMARK_RANGE_START, BENCHMARK_RANGE_END);
+
+
+/**
+ * Peak resident set size of the process, in KiB.
+ */
+static double max_rss_kib() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#else
+    return static_cast<double>(usage.ru_maxrss);
+#endif
+}
+
+/**
+ * Reports items/sec, bytes/sec and the process' peak RSS, so regressions in either speed or footprint show up.
+ */
+static void report_throughput(benchmark::State& state, const int64_t items_per_iteration, const int64_t bytes_per_iteration) {
+    state.SetItemsProcessed(state.iterations() * items_per_iteration);
+    state.SetBytesProcessed(state.iterations() * bytes_per_iteration);
+    state.counters["max_rss_kib"] = max_rss_kib();
+}
+
+/**
+ * Allocator backends compared by the raw allocation benchmarks.
+ * Each hands out `size` bytes aligned to `align`, and `reset()` returns everything handed out since the last reset.
+ */
+struct ArenaBackend {
+    ArenaV2 arena{1 << 20, ArenaGrowthPolicy::geometric(2.0, 1 << 26)};
+
+    void* allocate(const size_t size, const size_t align) noexcept {return arena.allocate_raw(size, align);}
+    void reset() {arena.clear();}
+};
+
+struct MonotonicBackend {
+    std::pmr::monotonic_buffer_resource resource{1 << 20};
+
+    void* allocate(const size_t size, const size_t align) {return resource.allocate(size, align);}
+    void reset() {resource.release();}
+};
+
+struct MallocBackend {
+    std::vector<void*> live;
+
+    void* allocate(const size_t size, const size_t align) {
+        void* p = align <= alignof(std::max_align_t) ? std::malloc(size) : std::aligned_alloc(align, (size + align - 1) & ~(align - 1));
+        live.push_back(p);
+        return p;
+    }
+
+    void reset() {
+        for (void* p : live) std::free(p);
+        live.clear();
+    }
+};
+
+#if defined(ARENA_BENCHMARK_JEMALLOC)
+struct JemallocBackend {
+    std::vector<void*> live;
+
+    void* allocate(const size_t size, const size_t align) {
+        void* p = mallocx(size, MALLOCX_ALIGN(align));
+        live.push_back(p);
+        return p;
+    }
+
+    void reset() {
+        for (void* p : live) dallocx(p, 0);
+        live.clear();
+    }
+};
+#endif
+
+#if defined(ARENA_BENCHMARK_MIMALLOC)
+struct MimallocBackend {
+    mi_heap_t* heap = mi_heap_new();
+
+    ~MimallocBackend() {mi_heap_destroy(heap);}
+
+    void* allocate(const size_t size, const size_t align) {return mi_heap_malloc_aligned(heap, size, align);}
+
+    // destroying the heap frees every block at once, the closest mimalloc has to an arena reset.
+    void reset() {
+        mi_heap_destroy(heap);
+        heap = mi_heap_new();
+    }
+};
+#endif
+
+/**
+ * Request sizes and alignments cycled through by the mixed-size distribution,
+ * skewed towards small objects like a typical node-heavy workload.
+ */
+static constexpr std::pair<size_t, size_t> MIXED_REQUESTS[] = {
+    {8, 8}, {16, 8}, {24, 8}, {1, 1}, {32, 16}, {8, 8}, {48, 16}, {3, 1},
+    {64, 8}, {16, 16}, {128, 16}, {8, 4}, {256, 64}, {24, 8}, {512, 16}, {40, 8},
+};
+
+/**
+ * `state.range(0)` allocations of `state.range(1)` bytes aligned to `state.range(2)`, then a reset.
+ * A size of 0 selects the mixed distribution of `MIXED_REQUESTS`.
+ */
+template<typename Backend>
+static void benchmark_raw_alloc(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    const auto size = static_cast<size_t>(state.range(1));
+    const auto align = static_cast<size_t>(state.range(2));
+    Backend backend;
+    int64_t bytes = 0;
+
+    for (auto _ : state) {
+        bytes = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            const auto& [mixed_size, mixed_align] = MIXED_REQUESTS[i % std::size(MIXED_REQUESTS)];
+            const size_t s = size ? size : mixed_size;
+            benchmark::DoNotOptimize(backend.allocate(s, size ? align : mixed_align));
+            bytes += static_cast<int64_t>(s);
+        }
+        backend.reset();
+    }
+
+    report_throughput(state, n, bytes);
+}
+
+static void raw_alloc_args(benchmark::internal::Benchmark* b) {
+    for (const int64_t size : {0, 8, 64, 512, 4096}) {
+        for (const int64_t align : {8, 64}) {
+            if (size == 0 && align != 8) continue;
+            b->Args({BENCHMARK_RANGE_END, size, align});
+        }
+    }
+    for (int64_t n = BENCHMARK_RANGE_START; n < BENCHMARK_LARGE_RANGE_END; n *= BENCHMARK_RANGE_MULTIPLIER) {
+        b->Args({n, 16, 8});
+    }
+    b->Args({BENCHMARK_LARGE_RANGE_END, 16, 8});
+    b->ArgNames({"n", "size", "align"});
+}
+
+BENCHMARK(benchmark_raw_alloc<ArenaBackend>)->Name("benchmark_raw_alloc_arena")->Apply(raw_alloc_args);
+BENCHMARK(benchmark_raw_alloc<MonotonicBackend>)->Name("benchmark_raw_alloc_pmr_monotonic")->Apply(raw_alloc_args);
+BENCHMARK(benchmark_raw_alloc<MallocBackend>)->Name("benchmark_raw_alloc_malloc")->Apply(raw_alloc_args);
+#if defined(ARENA_BENCHMARK_JEMALLOC)
+BENCHMARK(benchmark_raw_alloc<JemallocBackend>)->Name("benchmark_raw_alloc_jemalloc")->Apply(raw_alloc_args);
+#endif
+#if defined(ARENA_BENCHMARK_MIMALLOC)
+BENCHMARK(benchmark_raw_alloc<MimallocBackend>)->Name("benchmark_raw_alloc_mimalloc")->Apply(raw_alloc_args);
+#endif
+
+struct TrivialObject {
+    int64_t a, b, c;
+};
+
+struct DestructibleObject {
+    int64_t a, b, c;
+    ~DestructibleObject() { benchmark::DoNotOptimize(a); }
+};
+
+/**
+ * `create<T>` throughput, with destructor registration for non-trivially destructible `T`.
+ */
+template<typename T>
+static void benchmark_create(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 arena(1 << 20, ArenaGrowthPolicy::geometric(2.0, 1 << 26));
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(arena.create<T>(i, i, i));
+        }
+        arena.clear();
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(sizeof(T)));
+}
+
+BENCHMARK(benchmark_create<TrivialObject>)->Name("benchmark_create_trivial")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END);
+BENCHMARK(benchmark_create<DestructibleObject>)->Name("benchmark_create_with_dtor")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END);
+
+/**
+ * The same `create` and `clear()` cycle on an `ObjectArena<T>`, which keeps no destructor records.
+ */
+template<typename T>
+static void benchmark_object_arena_create(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ObjectArena<T> arena(ArenaOptions{.block_size = 1 << 20, .growth = ArenaGrowthPolicy::geometric(2.0, 1 << 26)});
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(arena.create(i, i, i));
+        }
+        arena.clear();
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(sizeof(T)));
+}
+
+BENCHMARK(benchmark_object_arena_create<TrivialObject>)->Name("benchmark_object_arena_create_trivial")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END);
+BENCHMARK(benchmark_object_arena_create<DestructibleObject>)->Name("benchmark_object_arena_create_with_dtor")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END);
+
+/**
+ * Linear scan over `n` objects, kept as pointers to `ArenaV2` allocations against iterating an `ObjectArena` directly.
+ */
+template<bool Slabs>
+static void benchmark_object_scan(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 arena(1 << 20, ArenaGrowthPolicy::geometric(2.0, 1 << 26));
+    ObjectArena<TrivialObject> objects(ArenaOptions{.block_size = 1 << 20, .growth = ArenaGrowthPolicy::geometric(2.0, 1 << 26)});
+    std::vector<TrivialObject*> pointers;
+
+    for (int64_t i = 0; i < n; ++i) {
+        if constexpr (Slabs) {
+            objects.create(i, i, i);
+        } else {
+            pointers.push_back(arena.create<TrivialObject>(i, i, i));
+        }
+    }
+
+    for (auto _ : state) {
+        int64_t sum = 0;
+        if constexpr (Slabs) {
+            for (const TrivialObject& obj : objects) sum += obj.a;
+        } else {
+            for (const TrivialObject* obj : pointers) sum += obj->a;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(sizeof(TrivialObject)));
+}
+
+BENCHMARK(benchmark_object_scan<false>)->Name("benchmark_object_scan_pointers")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END);
+BENCHMARK(benchmark_object_scan<true>)->Name("benchmark_object_scan_object_arena")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END);
+
+/**
+ * Cost of `clear()` alone against the number of registered objects.
+ */
+static void benchmark_clear_vs_object_count(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 arena(1 << 20, ArenaGrowthPolicy::geometric(2.0, 1 << 26));
+
+    for (auto _ : state) {
+        for (int64_t i = 0; i < n; ++i) {
+            arena.create<DestructibleObject>(i, i, i);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        arena.clear();
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(sizeof(DestructibleObject)));
+}
+
+BENCHMARK(benchmark_clear_vs_object_count)
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END)
+    ->UseManualTime();
+
+/**
+ * Construction and destruction of an empty arena with a `state.range(0)`-byte first block.
+ */
+static void benchmark_arena_construction(benchmark::State& state) {
+    const auto block_size = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        ArenaV2 arena(block_size);
+        benchmark::DoNotOptimize(arena.allocate_raw(8, 8));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void benchmark_inline_arena_construction(benchmark::State& state) {
+    for (auto _ : state) {
+        InlineArenaV2<1024> arena;
+        benchmark::DoNotOptimize(arena.allocate_raw(8, 8));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(benchmark_arena_construction)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(benchmark_inline_arena_construction);
+
+/**
+ * Requests sized so that every `state.range(1)`-th allocation rolls over to a new block,
+ * measuring the slow path including fresh blocks from the heap.
+ */
+static void benchmark_block_rollover(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    const auto per_block = static_cast<size_t>(state.range(1));
+    constexpr size_t request = 64;
+
+    for (auto _ : state) {
+        ArenaV2 arena(request * per_block);
+        for (int64_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(arena.allocate_raw(request, 8));
+        }
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(request));
+    state.counters["blocks"] = static_cast<double>(n) / static_cast<double>(per_block);
+}
+
+BENCHMARK(benchmark_block_rollover)->ArgsProduct({{BENCHMARK_RANGE_END}, {1, 16, 256}});
+
+/**
+ * The same requests on an arena backed by reserved address space, which grows its single block in place.
+ */
+static void benchmark_reserved_block_rollover(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    const auto per_block = static_cast<size_t>(state.range(1));
+    constexpr size_t request = 64;
+    ReservedBlockSource source;
+
+    for (auto _ : state) {
+        ArenaV2 arena(ArenaOptions{.block_size = request * per_block, .source = &source});
+        for (int64_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(arena.allocate_raw(request, 8));
+        }
+        state.counters["blocks"] = static_cast<double>(arena.get_number_of_allocated_blocks());
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(request));
+}
+
+BENCHMARK(benchmark_reserved_block_rollover)->ArgsProduct({{BENCHMARK_RANGE_END, BENCHMARK_LARGE_RANGE_END}, {1, 16, 256}});
+BENCHMARK(benchmark_block_rollover)->Name("benchmark_block_rollover_large")->ArgsProduct({{BENCHMARK_LARGE_RANGE_END}, {1, 16, 256}});
+
+/**
+ * The same batch of work on one arena cleared between cycles, against a fresh arena per cycle.
+ */
+template<bool Reuse>
+static void benchmark_arena_cycles(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 shared(8192);
+
+    const auto run = [n](ArenaV2& arena) {
+        for (int64_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(arena.create<TrivialObject>(i, i, i));
+        }
+    };
+
+    for (auto _ : state) {
+        if constexpr (Reuse) {
+            run(shared);
+            shared.clear();
+        } else {
+            ArenaV2 fresh(8192);
+            run(fresh);
+        }
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(sizeof(TrivialObject)));
+}
+
+BENCHMARK(benchmark_arena_cycles<true>)->Name("benchmark_arena_cycles_reuse")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 18);
+BENCHMARK(benchmark_arena_cycles<false>)->Name("benchmark_arena_cycles_fresh")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 18);
+
+/**
+ * A fresh per-batch arena, either a child borrowing its blocks from a long-lived parent or an independent arena.
+ */
+template<bool Child>
+static void benchmark_batch_arena(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    ArenaV2 parent(1 << 20);
+
+    for (auto _ : state) {
+        if constexpr (Child) {
+            ChildArenaV2 batch = parent.make_child(8192);
+            for (int64_t i = 0; i < n; ++i) {
+                benchmark::DoNotOptimize(batch.create<TrivialObject>(i, i, i));
+            }
+        } else {
+            ArenaV2 batch(8192);
+            for (int64_t i = 0; i < n; ++i) {
+                benchmark::DoNotOptimize(batch.create<TrivialObject>(i, i, i));
+            }
+        }
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(sizeof(TrivialObject)));
+}
+
+BENCHMARK(benchmark_batch_arena<true>)->Name("benchmark_batch_arena_child")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 18);
+BENCHMARK(benchmark_batch_arena<false>)->Name("benchmark_batch_arena_independent")
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 18);
+
+struct LookupNode {
+    int64_t key;
+    int64_t value;
+    arena_ptr<LookupNode> next;
+};
+
+/**
+ * Builds a chained lookup table of `n` nodes linked with `arena_ptr`, returning its bucket array.
+ */
+static arena_span<arena_ptr<LookupNode>> build_lookup_table(ArenaV2& arena, const int64_t n) {
+    const auto n_buckets = static_cast<size_t>(n);
+    auto* buckets = arena.create_array<arena_ptr<LookupNode>>(n_buckets);
+    for (int64_t i = 0; i < n; ++i) {
+        arena_ptr<LookupNode>& head = buckets[static_cast<size_t>(i * 7919) % n_buckets];
+        head = arena.to_arena_ptr(arena.create<LookupNode>(i, i * 2, head));
+    }
+    return arena.to_arena_span(buckets, n_buckets);
+}
+
+template<typename Resolver>
+static int64_t sum_lookup_table(const Resolver& resolver, const arena_span<arena_ptr<LookupNode>>& table) {
+    int64_t sum = 0;
+    for (const arena_ptr<LookupNode>& head : resolver.resolve(table)) {
+        for (const LookupNode* node = resolver.resolve(head); node; node = resolver.resolve(node->next)) {
+            sum += node->value;
+        }
+    }
+    return sum;
+}
+
+/**
+ * Cold start of a read-only lookup table: rebuilding it in a fresh arena, against mapping a snapshot of it.
+ */
+static void benchmark_lookup_table_rebuild(benchmark::State& state) {
+    const int64_t n = state.range(0);
+
+    for (auto _ : state) {
+        ArenaV2 arena(1 << 20);
+        const auto table = build_lookup_table(arena, n);
+        benchmark::DoNotOptimize(sum_lookup_table(arena, table));
+    }
+
+    report_throughput(state, n, n * static_cast<int64_t>(sizeof(LookupNode)));
+}
+
+static void benchmark_lookup_table_snapshot_reload(benchmark::State& state) {
+    const int64_t n = state.range(0);
+
+    FILE* file = std::tmpfile();
+    {
+        ArenaV2 arena(1 << 20);
+        const auto table = build_lookup_table(arena, n);
+        arena.snapshot(fileno(file), arena.to_arena_ptr(arena.create<arena_span<arena_ptr<LookupNode>>>(table)));
+    }
+
+    for (auto _ : state) {
+        const MappedArena mapped(fileno(file));
+        benchmark::DoNotOptimize(sum_lookup_table(mapped, *mapped.root<arena_span<arena_ptr<LookupNode>>>()));
+    }
+    std::fclose(file);
+
+    report_throughput(state, n, n * static_cast<int64_t>(sizeof(LookupNode)));
+}
+
+BENCHMARK(benchmark_lookup_table_rebuild)
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END);
+BENCHMARK(benchmark_lookup_table_snapshot_reload)
+    ->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, BENCHMARK_LARGE_RANGE_END);
+
+/**
+ * Token stream of `n` identifiers drawn from a vocabulary of 1024, as a tokenizer would see them.
+ */
+static std::vector<std::string> make_token_stream(const int64_t n) {
+    std::vector<std::string> tokens;
+    tokens.reserve(static_cast<size_t>(n));
+    for (int64_t i = 0; i < n; ++i) {
+        tokens.push_back("identifier_" + std::to_string((i * 7919) % 1024));
+    }
+    return tokens;
+}
+
+using ArenaStdString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+static void benchmark_string_copy_arena_allocator(benchmark::State& state) {
+    const auto tokens = make_token_stream(state.range(0));
+
+    for (auto _ : state) {
+        ArenaV2 arena(1 << 16);
+        for (const std::string& token : tokens) {
+            benchmark::DoNotOptimize(arena.create<ArenaStdString>(token, ArenaAllocator<char>(arena)));
+        }
+    }
+
+    report_throughput(state, state.range(0), 0);
+}
+
+static void benchmark_string_copy_string(benchmark::State& state) {
+    const auto tokens = make_token_stream(state.range(0));
+
+    for (auto _ : state) {
+        ArenaV2 arena(1 << 16);
+        for (const std::string& token : tokens) {
+            benchmark::DoNotOptimize(arena.copy_string(token));
+        }
+    }
+
+    report_throughput(state, state.range(0), 0);
+}
+
+static void benchmark_intern_unordered_set(benchmark::State& state) {
+    const auto tokens = make_token_stream(state.range(0));
+
+    for (auto _ : state) {
+        std::unordered_set<std::string> table;
+        for (const std::string& token : tokens) {
+            benchmark::DoNotOptimize(table.insert(token).first->data());
+        }
+    }
+
+    report_throughput(state, state.range(0), 0);
+}
+
+static void benchmark_intern_arena(benchmark::State& state) {
+    const auto tokens = make_token_stream(state.range(0));
+
+    for (auto _ : state) {
+        ArenaV2 arena(1 << 16);
+        ArenaInterner interner(arena);
+        for (const std::string& token : tokens) {
+            benchmark::DoNotOptimize(interner.intern(token).data());
+        }
+    }
+
+    report_throughput(state, state.range(0), 0);
+}
+
+BENCHMARK(benchmark_string_copy_arena_allocator)->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 20);
+BENCHMARK(benchmark_string_copy_string)->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 20);
+BENCHMARK(benchmark_intern_unordered_set)->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 20);
+BENCHMARK(benchmark_intern_arena)->RangeMultiplier(BENCHMARK_RANGE_MULTIPLIER)->Range(BENCHMARK_RANGE_START, 1 << 20);
+
+struct HeapPromise {};
+
+/**
+ * Lazily started task whose frame comes from the heap, or from the current arena when `Arena` is set.
+ */
+template<bool Arena>
+struct BenchmarkTask {
+    struct promise_type : std::conditional_t<Arena, ArenaCoroutinePromise, HeapPromise> {
+        int64_t value = 0;
+
+        BenchmarkTask get_return_object() {
+            return BenchmarkTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept {return {};}
+        std::suspend_always final_suspend() noexcept {return {};}
+        void return_value(const int64_t v) noexcept {value = v;}
+        void unhandled_exception() {std::terminate();}
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit BenchmarkTask(const std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    BenchmarkTask(BenchmarkTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    ~BenchmarkTask() { if (handle) handle.destroy(); }
+
+    int64_t run() {
+        handle.resume();
+        return handle.promise().value;
+    }
+};
+
+template<bool Arena>
+__attribute__((noinline)) static BenchmarkTask<Arena> spawn_task(const int64_t i) {
+    co_return i * 3;
+}
+
+/**
+ * Spawns `state.range(0)` coroutines per iteration. With `state.range(1) == 0` each task runs and is destroyed
+ * before the next is spawned, so arena frames are reclaimed in place; otherwise the whole batch is kept alive
+ * and destroyed together, and the arena is cleared after it.
+ */
+template<bool Arena>
+static void benchmark_coroutine_spawn(benchmark::State& state) {
+    const int64_t n = state.range(0);
+    const bool batch = state.range(1) != 0;
+    ArenaV2 arena(1 << 20);
+    ArenaCoroutineScope scope(arena);
+    std::vector<BenchmarkTask<Arena>> tasks;
+    tasks.reserve(static_cast<size_t>(n));
+
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (int64_t i = 0; i < n; ++i) {
+            BenchmarkTask<Arena> task = spawn_task<Arena>(i);
+            sum += task.run();
+            if (batch) tasks.push_back(std::move(task));
+        }
+        tasks.clear();
+        arena.clear();
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(benchmark_coroutine_spawn<false>)->Name("benchmark_coroutine_spawn_heap")
+    ->ArgsProduct({{BENCHMARK_RANGE_START, 1 << 16}, {0, 1}});
+BENCHMARK(benchmark_coroutine_spawn<true>)->Name("benchmark_coroutine_spawn_arena")
+    ->ArgsProduct({{BENCHMARK_RANGE_START, 1 << 16}, {0, 1}});
+
+constexpr int BENCHMARK_THREADS_START = 1;
+constexpr int BENCHMARK_THREADS_END = 64;
+constexpr int64_t BENCHMARK_ALLOCS_PER_THREAD = 1<<18;
+constexpr size_t BENCHMARK_SHARED_ARENA_SIZE = 1<<26;
+
+// shared arenas are created by thread 0 before the timed loop and destroyed after it,
+// benchmark synchronises all threads at the start and end of the loop.
+static void benchmark_shared_alloc_mutex_arena(benchmark::State& state) {
+    static ArenaV2* arena = nullptr;
+    static std::mutex mutex;
+    if (state.thread_index() == 0) arena = new ArenaV2(BENCHMARK_SHARED_ARENA_SIZE);
+
+    for (auto _ : state) {
+        std::lock_guard lock(mutex);
+        benchmark::DoNotOptimize(arena->allocate_raw(16, 8));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) delete arena;
+}
+
+static void benchmark_shared_alloc_atomic_arena(benchmark::State& state) {
+    static AtomicArena* arena = nullptr;
+    if (state.thread_index() == 0) arena = new AtomicArena(BENCHMARK_SHARED_ARENA_SIZE);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(arena->allocate_raw(16, 8));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) delete arena;
+}
+
+static void benchmark_shared_alloc_concurrent_arena(benchmark::State& state) {
+    static ConcurrentArena* arena = nullptr;
+    if (state.thread_index() == 0) arena = new ConcurrentArena();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(arena->allocate_raw(16, 8));
+    }
+
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) delete arena;
+}
+
+BENCHMARK(benchmark_shared_alloc_mutex_arena)->ThreadRange(BENCHMARK_THREADS_START, BENCHMARK_THREADS_END)->Iterations(BENCHMARK_ALLOCS_PER_THREAD)->UseRealTime();
+BENCHMARK(benchmark_shared_alloc_atomic_arena)->ThreadRange(BENCHMARK_THREADS_START, BENCHMARK_THREADS_END)->Iterations(BENCHMARK_ALLOCS_PER_THREAD)->UseRealTime();
+BENCHMARK(benchmark_shared_alloc_concurrent_arena)->ThreadRange(BENCHMARK_THREADS_START, BENCHMARK_THREADS_END)->Iterations(BENCHMARK_ALLOCS_PER_THREAD)->UseRealTime();
+
 BENCHMARK_MAIN();
\ No newline at end of file
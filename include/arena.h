@@ -5,12 +5,536 @@
 #ifndef ARENAV2_H
 #define ARENAV2_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
 #include <vector>
 #include <functional>
+#include <future>
 #include <memory>
+#include <source_location>
+#include <span>
+#include <string_view>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+/**
+ * Define `ARENA_STATS` to 1 (CMake option `ARENA_STATS`) to let `ArenaV2::get_stats()` report real counters.
+ * Every translation unit of a program must agree on the value.
+ */
+#ifndef ARENA_STATS
+#define ARENA_STATS 0
+#endif
+
+/**
+ * Define `ARENA_DEBUG` to 1 (CMake option `ARENA_DEBUG`) to check arena memory the way `malloc` is checked:
+ * under AddressSanitizer free block tails and everything released by `clear()` or `rewind()` are poisoned,
+ * and with `ArenaOptions::debug_redzone` set every allocation is followed by a canary verified on `clear()`.
+ * Every translation unit of a program must agree on the value.
+ */
+#ifndef ARENA_DEBUG
+#define ARENA_DEBUG 0
+#endif
+
+/**
+ * Define `ARENA_PROFILE` to 1 (CMake option `ARENA_PROFILE`) to report sampled allocations to the hook installed
+ * with `ArenaProfiler::install()`. Without it the hooks compile away.
+ * Every translation unit of a program must agree on the value.
+ */
+#ifndef ARENA_PROFILE
+#define ARENA_PROFILE 0
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define ARENA_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ARENA_ASAN 1
+#endif
+#endif
+
+#if ARENA_DEBUG
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+#if ARENA_DEBUG && defined(ARENA_ASAN)
+#include <sanitizer/asan_interface.h>
+#define ARENA_POISON(ptr, size) ASAN_POISON_MEMORY_REGION(ptr, size)
+#define ARENA_UNPOISON(ptr, size) ASAN_UNPOISON_MEMORY_REGION(ptr, size)
+#else
+#define ARENA_POISON(ptr, size) ((void) (ptr), (void) (size))
+#define ARENA_UNPOISON(ptr, size) ((void) (ptr), (void) (size))
+#endif
 
 inline constexpr size_t DEFAULT_BLOCK_SIZE = 1024;
 inline constexpr size_t DESTRUCTOR_CHUNK_SIZE = 32;
+inline constexpr size_t DEFAULT_MAX_BLOCK_SIZE = 64 * 1024 * 1024;
+inline constexpr size_t INLINE_ARENA_BLOCK_SLOTS = 4;
+inline constexpr size_t PARALLEL_CLEAR_MIN_OBJECTS_PER_THREAD = 4096;
+inline constexpr unsigned ARENA_PTR_OFFSET_BITS = 40;
+inline constexpr size_t ARENA_SNAPSHOT_ALIGNMENT = 4096;
+inline constexpr uint32_t ARENA_SNAPSHOT_VERSION = 1;
+inline constexpr char ARENA_SNAPSHOT_MAGIC[8] = {'A', 'R', 'E', 'N', 'A', 'S', 'N', 'P'};
+inline constexpr unsigned char ARENA_DEBUG_CANARY = 0xCD;
+inline constexpr size_t DEFAULT_ARENA_PROFILE_SAMPLE_INTERVAL = 512 * 1024;
+
+/**
+ * @brief Decides the size of each block the arena requests once its current blocks are exhausted.
+ *
+ * The policy is only consulted on the (non-inline) slow path, so it never touches the allocation fast path.
+ *
+ * - `fixed()`: every new block is `block_size` bytes (the original behaviour).
+ * - `geometric(factor, max_block_size)`: each new block is `factor` times the previous one, capped at `max_block_size`.
+ *   This reduces the number of system allocations from O(n) to O(log n).
+ * - `custom(fn)`: `fn(previous_block_size)` returns the size of the next block.
+ *
+ * A new block is always large enough to service the request that triggered it.
+ */
+struct ArenaGrowthPolicy {
+    enum class Kind { Fixed, Geometric, Custom };
+
+    Kind kind = Kind::Fixed;
+    double factor = 2.0;
+    size_t max_block_size = DEFAULT_MAX_BLOCK_SIZE;
+    size_t (*next_block_size_fn)(size_t previous_block_size) = nullptr;
+
+    static constexpr ArenaGrowthPolicy fixed() noexcept {
+        return ArenaGrowthPolicy{};
+    }
+
+    static constexpr ArenaGrowthPolicy geometric(const double factor = 2.0,
+                                                 const size_t max_block_size = DEFAULT_MAX_BLOCK_SIZE) noexcept {
+        return ArenaGrowthPolicy{Kind::Geometric, factor, max_block_size, nullptr};
+    }
+
+    static constexpr ArenaGrowthPolicy custom(size_t (*fn)(size_t previous_block_size)) noexcept {
+        return ArenaGrowthPolicy{Kind::Custom, 1.0, DEFAULT_MAX_BLOCK_SIZE, fn};
+    }
+
+    /**
+     * @brief Computes the block size that follows `previous_block_size`.
+     */
+    [[nodiscard]] size_t next(const size_t previous_block_size) const noexcept {
+        switch (kind) {
+            case Kind::Geometric: {
+                const auto grown = static_cast<size_t>(static_cast<double>(previous_block_size) * factor);
+                return std::max(previous_block_size, std::min(grown, max_block_size));
+            }
+            case Kind::Custom:
+                return next_block_size_fn(previous_block_size);
+            case Kind::Fixed:
+            default:
+                return previous_block_size;
+        }
+    }
+};
+
+/**
+ * @brief Backing memory for the arena's blocks.
+ *
+ * A block source is a pair of function pointers rather than a virtual interface, following the
+ * compile-time dispatch used for destructors. It is only called when blocks are added or released,
+ * never on the allocation fast path.
+ *
+ * `allocate` may round `size` up to its own granularity (e.g. pages) and reports the usable size back,
+ * the same size is handed to `deallocate`. It returns nullptr on failure.
+ *
+ * Two optional hooks let a source do more than hand out blocks:
+ * - `extend_fn` grows a block in place to at least `size` bytes, or as far as it can, reporting the new size back.
+ *   The arena tries it before moving on to a new block, so a source backed by reserved address space
+ *   keeps the whole arena in one contiguous block.
+ * - `discard_fn` is told by `clear()` that a block's contents are dead, so the source may return its pages.
+ *
+ * Sources whose `deallocate` must run on the arena's own thread clear `thread_agnostic`,
+ * `clear_async()` then releases their blocks synchronously.
+ *
+ * @note A source is not owned by the arena and must outlive every arena drawing from it.
+ */
+struct BlockSource {
+    void* (*allocate_fn)(BlockSource* self, size_t& size) noexcept;
+    void (*deallocate_fn)(BlockSource* self, void* ptr, size_t size) noexcept;
+    bool (*extend_fn)(BlockSource* self, void* ptr, size_t old_size, size_t& size) noexcept = nullptr;
+    void (*discard_fn)(BlockSource* self, void* ptr, size_t size) noexcept = nullptr;
+    bool thread_agnostic = true;
+
+    void* allocate(size_t& size) noexcept {return allocate_fn(this, size);}
+    void deallocate(void* ptr, const size_t size) noexcept {deallocate_fn(this, ptr, size);}
+    bool extend(void* ptr, const size_t old_size, size_t& size) noexcept {return extend_fn(this, ptr, old_size, size);}
+    void discard(void* ptr, const size_t size) noexcept {discard_fn(this, ptr, size);}
+};
+
+/**
+ * @brief Default block source, backed by the global `::operator new`.
+ */
+struct HeapBlockSource : BlockSource {
+    constexpr HeapBlockSource() noexcept : BlockSource{&heap_allocate, &heap_deallocate} {}
+
+private:
+    static void* heap_allocate(BlockSource*, size_t& size) noexcept {
+        return ::operator new(size, std::nothrow);
+    }
+
+    static void heap_deallocate(BlockSource*, void* ptr, size_t) noexcept {
+        ::operator delete(ptr);
+    }
+};
+
+/**
+ * @return Process-wide heap block source used by default.
+ */
+inline BlockSource* heap_block_source() noexcept {
+    static HeapBlockSource source;
+    return &source;
+}
+
+/**
+ * @brief Auto-tuning of an arena's blocks from the usage it observes across `clear()` cycles.
+ *
+ * On every clear the arena folds the bytes used in the finished cycle into a high-water mark,
+ * and when that cycle spilled over several blocks, replaces its blocks with a single block of
+ * `high_water_mark * headroom` bytes. The next cycle of the same shape then runs in one contiguous block
+ * without slow-path calls. After a spike the mark decays towards lower usage, and a block more than
+ * twice the target is shrunk back.
+ */
+struct ArenaAdaptiveSizing {
+    /** Enables auto-tuning. */
+    bool enabled = false;
+
+    /** Multiplier applied to the high-water mark when sizing the coalesced block. */
+    double headroom = 1.25;
+
+    /** Fraction of the gap between the high-water mark and a lower cycle's usage closed on each clear. */
+    double decay = 0.25;
+};
+
+/**
+ * @brief Release of retained blocks the arena has stopped using, checked on every `clear()`.
+ *
+ * Blocks are retained across `clear()` so that later cycles refill them without asking the source again.
+ * With `idle_clears` set, a retained block that no cycle entered during the last `idle_clears` clears
+ * is returned to its source, newest first, until the arena is down to `keep_bytes`.
+ * A long-lived arena that once spiked thus decays back to the footprint of its recent cycles.
+ * Blocks are only ever released from within `clear()`, the arena never starts a thread of its own.
+ */
+struct ArenaRetentionPolicy {
+    /** Number of clears a retained block may go unused before it is released, 0 retains blocks forever. */
+    size_t idle_clears = 0;
+
+    /** Bytes of blocks kept regardless of idleness. */
+    size_t keep_bytes = 0;
+};
+
+/**
+ * @brief Opt-out trait for destructor registration.
+ *
+ * Specialise to `std::true_type` for types whose destructor has no effect worth running once their arena goes away,
+ * e.g. views into the arena or containers whose storage is itself arena-allocated.
+ * `create` and the array variants then skip the destructor record, exactly as for trivially destructible types.
+ *
+ * @code
+ * template<> struct arena_skip_destroy<ParseNode> : std::true_type {};
+ * @endcode
+ */
+template<typename T>
+struct arena_skip_destroy : std::false_type {};
+
+template<typename T>
+inline constexpr bool arena_skip_destroy_v = arena_skip_destroy<T>::value;
+
+/**
+ * @brief Construction-time configuration of an `ArenaV2`.
+ */
+struct ArenaOptions {
+    /** Size (in bytes) of the first block, and of every block under the fixed growth policy. */
+    size_t block_size = DEFAULT_BLOCK_SIZE;
+
+    /** Size of blocks requested after the first one. */
+    ArenaGrowthPolicy growth = ArenaGrowthPolicy::fixed();
+
+    /** Where block memory comes from, e.g. `MmapBlockSource` for huge pages. */
+    BlockSource* source = heap_block_source();
+
+    /**
+     * Never register destructors, so `clear()` only resets offsets.
+     * For arenas whose objects hold nothing but other arena memory.
+     */
+    bool leak_destructors = false;
+
+    /** Size blocks from the usage observed across `clear()` cycles instead of `block_size` alone. */
+    ArenaAdaptiveSizing adaptive = {};
+
+    /** Release retained blocks left idle across `clear()` cycles. */
+    ArenaRetentionPolicy retention = {};
+
+    /**
+     * Bytes of canary placed after every allocation, checked on `clear()`, `rewind()` and destruction.
+     * Only used when `ARENA_DEBUG` is enabled. Keep it a multiple of 8 so AddressSanitizer can poison it exactly.
+     */
+    size_t debug_redzone = 0;
+};
+
+/**
+ * @brief Snapshot of an arena's allocation counters, see `ArenaV2::get_stats()`.
+ *
+ * Counters accumulate from construction (or `ArenaV2::reset_stats()`) across `clear()`,
+ * apart from `bytes_in_use` which describes the arena at the time of the snapshot.
+ * Destructor chunks are allocated from the arena like any other request,
+ * `destructor_chunk_bytes` says how much of `bytes_requested` they account for.
+ * Every counter stays zero unless `ARENA_STATS` is enabled.
+ */
+struct ArenaStats {
+    /** Whether the counters are maintained in this build. */
+    static constexpr bool enabled = ARENA_STATS;
+
+    /** Number of bump allocations. */
+    size_t n_allocations = 0;
+
+    /** Bytes asked for by allocations. */
+    size_t bytes_requested = 0;
+
+    /** Bytes the bump pointer advanced by, i.e. `bytes_requested + padding_bytes`. */
+    size_t bytes_consumed = 0;
+
+    /** Bytes skipped to align allocations. */
+    size_t padding_bytes = 0;
+
+    /** Bytes left unused at the end of blocks the arena moved past. */
+    size_t tail_waste_bytes = 0;
+
+    /** Number of allocations that did not fit their block and took the slow path. */
+    size_t n_slow_path = 0;
+
+    /** Number of destructor registrations, including those coalesced into an existing run. */
+    size_t n_destructor_registrations = 0;
+
+    /** Bytes taken by destructor chunks. */
+    size_t destructor_chunk_bytes = 0;
+
+    /** Bytes currently allocated from the arena's blocks, padding included. */
+    size_t bytes_in_use = 0;
+
+    /** Highest `bytes_in_use` observed. */
+    size_t peak_bytes_in_use = 0;
+
+    /** Bytes of all blocks owned by the arena. */
+    size_t bytes_reserved = 0;
+};
+
+/**
+ * @brief Position-independent pointer to an arena object, stored as a block index and an offset into that block.
+ *
+ * Unlike `T*`, an `arena_ptr` stays meaningful when the arena's blocks are written out by `ArenaV2::snapshot()`
+ * and mapped back at another address by `MappedArena`, so structures linked with it reload without pointer fixups.
+ * It is resolved against the arena (or mapped snapshot) holding the object, with `resolve()`.
+ * A default-constructed `arena_ptr` is null.
+ *
+ * Offsets take the low `ARENA_PTR_OFFSET_BITS` bits and the block index the rest.
+ *
+ * @tparam T Type of the object pointed to.
+ */
+template<typename T>
+class arena_ptr {
+public:
+    constexpr arena_ptr() noexcept = default;
+    constexpr arena_ptr(std::nullptr_t) noexcept {}
+
+    constexpr arena_ptr(const size_t block_index, const size_t block_offset) noexcept :
+        handle(((static_cast<uint64_t>(block_index) + 1) << ARENA_PTR_OFFSET_BITS) | block_offset) {}
+
+    /** @return Index of the block holding the object. */
+    [[nodiscard]] constexpr size_t block_index() const noexcept {
+        return static_cast<size_t>((handle >> ARENA_PTR_OFFSET_BITS) - 1);
+    }
+
+    /** @return Offset (in bytes) of the object from the start of its block. */
+    [[nodiscard]] constexpr size_t block_offset() const noexcept {
+        return static_cast<size_t>(handle & ((uint64_t{1} << ARENA_PTR_OFFSET_BITS) - 1));
+    }
+
+    /** @return Encoded handle, 0 for null. */
+    [[nodiscard]] constexpr uint64_t raw() const noexcept {return handle;}
+
+    /** @return Pointer decoded from a handle returned by `raw()`. */
+    [[nodiscard]] static constexpr arena_ptr from_raw(const uint64_t raw) noexcept {
+        arena_ptr ptr;
+        ptr.handle = raw;
+        return ptr;
+    }
+
+    constexpr explicit operator bool() const noexcept {return handle != 0;}
+
+    constexpr bool operator==(const arena_ptr&) const noexcept = default;
+
+private:
+    uint64_t handle = 0;
+};
+
+/**
+ * @brief Position-independent array of `size` objects, the `arena_ptr` counterpart of `std::span`.
+ *
+ * Lets snapshotted structures hold variable-length data (strings, buckets, child lists).
+ */
+template<typename T>
+struct arena_span {
+    arena_ptr<T> data;
+    size_t size = 0;
+};
+
+/**
+ * @brief Header of a file written by `ArenaV2::snapshot()`.
+ *
+ * Followed by `n_blocks` `ArenaSnapshotBlock` records, then the used bytes of every block.
+ * Each block's bytes start at the same address modulo `ARENA_SNAPSHOT_ALIGNMENT` as its buffer did,
+ * so objects aligned up to `ARENA_SNAPSHOT_ALIGNMENT` stay aligned once the file is mapped.
+ */
+struct ArenaSnapshotHeader {
+    char magic[sizeof(ARENA_SNAPSHOT_MAGIC)];
+    uint32_t version;
+    uint32_t n_blocks;
+    uint64_t root;
+    uint64_t file_size;
+};
+
+/**
+ * @brief Location of one block's bytes within a snapshot file.
+ */
+struct ArenaSnapshotBlock {
+    uint64_t file_offset;
+    uint64_t size;
+};
+
+/**
+ * @return Readable name of `T`, taken from the compiler's signature of this function.
+ */
+template<typename T>
+constexpr std::string_view arena_type_name() noexcept {
+#if defined(__clang__) || defined(__GNUC__)
+    // "... arena_type_name() [with T = Foo; ...]" (GCC) or "... arena_type_name() [T = Foo]" (Clang).
+    constexpr std::string_view signature = __PRETTY_FUNCTION__;
+    constexpr size_t first = signature.find("T = ") + 4;
+    return signature.substr(first, signature.find_first_of(";]", first) - first);
+#elif defined(_MSC_VER)
+    // "... arena_type_name<Foo>(void) noexcept".
+    constexpr std::string_view signature = __FUNCSIG__;
+    constexpr size_t first = signature.find("arena_type_name<") + 16;
+    return signature.substr(first, signature.rfind(">(void)") - first);
+#else
+    return "unknown";
+#endif
+}
+
+/**
+ * @brief One sampled allocation, passed to the hook installed with `ArenaProfiler::install()`.
+ */
+struct ArenaAllocationSample {
+    /** Bytes requested. */
+    size_t size;
+
+    /** Alignment requested. */
+    size_t align;
+
+    /** Allocated type, see `arena_type_name()`. Empty for untyped requests such as `allocate_raw()`. */
+    std::string_view type_name;
+
+    /** Call site given to `ArenaV2::create_at()`, default-constructed (line 0) otherwise. */
+    std::source_location location;
+
+    /** Bytes allocated on this thread since the previous sample, this one included: the bytes the sample stands for. */
+    size_t sampled_bytes;
+};
+
+/**
+ * @brief Receives sampled allocations. Called on the allocating thread, so it must be thread-safe,
+ * and it must not allocate from an arena itself.
+ */
+using ArenaProfileHook = void (*)(const ArenaAllocationSample& sample, void* user_data);
+
+/**
+ * @class ArenaProfiler
+ * @brief Process-wide sampler of arena allocations, active in builds with `ARENA_PROFILE`.
+ *
+ * Like tcmalloc's sampler, every thread counts the bytes it allocates and reports one allocation
+ * each time the count reaches the sample interval. The sample carries the bytes counted since the previous one,
+ * so summing `sampled_bytes` per call site estimates each site's share of the total without recording every request.
+ * An interval of 1 reports every allocation.
+ *
+ * @code
+ * ArenaProfiler::install(&on_sample, &collector, 64 * 1024);
+ * @endcode
+ */
+class ArenaProfiler {
+public:
+    /**
+     * @brief Installs `hook`, replacing any previous one, and restarts sampling at `sample_interval` bytes.
+     *
+     * Every thread drops the bytes it counted towards its next sample on its first allocation after the install.
+     */
+    static void install(const ArenaProfileHook hook, void* user_data = nullptr,
+                        const size_t sample_interval = DEFAULT_ARENA_PROFILE_SAMPLE_INTERVAL) noexcept {
+        current_user_data.store(user_data, std::memory_order_relaxed);
+        interval.store(sample_interval, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_relaxed);
+        current_hook.store(hook, std::memory_order_release);
+    }
+
+    /**
+     * @brief Stops sampling.
+     */
+    static void uninstall() noexcept {
+        current_hook.store(nullptr, std::memory_order_release);
+    }
+
+    /** @return User data given to `install()`. */
+    [[nodiscard]] static void* get_user_data() noexcept {return current_user_data.load(std::memory_order_relaxed);}
+
+    /** @return Bytes allocated per sample. */
+    [[nodiscard]] static size_t get_sample_interval() noexcept {return interval.load(std::memory_order_relaxed);}
+
+    /**
+     * @brief Counts one allocation on the calling thread, reporting it if the sample interval is reached.
+     */
+    static void record(const size_t size, const size_t align, const std::string_view type_name,
+                       const std::source_location& location) noexcept {
+        const ArenaProfileHook hook = current_hook.load(std::memory_order_acquire);
+        if (!hook) return;
+
+        const uint64_t installed = generation.load(std::memory_order_relaxed);
+        if (seen_generation != installed) [[unlikely]] {
+            seen_generation = installed;
+            bytes_since_sample = 0;
+        }
+
+        bytes_since_sample += size;
+        if (bytes_since_sample < interval.load(std::memory_order_relaxed)) return;
+
+        const ArenaAllocationSample sample{size, align, type_name, location, bytes_since_sample};
+        bytes_since_sample = 0;
+        hook(sample, current_user_data.load(std::memory_order_relaxed));
+    }
+
+private:
+    static inline std::atomic<ArenaProfileHook> current_hook{nullptr};
+    static inline std::atomic<void*> current_user_data{nullptr};
+    static inline std::atomic<size_t> interval{DEFAULT_ARENA_PROFILE_SAMPLE_INTERVAL};
+    static inline std::atomic<uint64_t> generation{0};
+    static inline thread_local size_t bytes_since_sample = 0;
+
+    /**
+     * Install `generation` the calling thread's count belongs to.
+     */
+    static inline thread_local uint64_t seen_generation = 0;
+};
+
+class ChildArenaV2;
 
 /**
  * @class ArenaV2
@@ -21,7 +545,7 @@ inline constexpr size_t DESTRUCTOR_CHUNK_SIZE = 32;
  * The arena grows automatically by allocating new blocks when required.
  *
  * Unlike fixed-size arenas, ArenaV2 does *not* fail when the current block is exhausted.
- * Instead, it allocates a new block of at least `block_size` bytes.
+ * Instead, it allocates a new block whose size is decided by its `ArenaGrowthPolicy`.
  *
  * Destruction of allocated objects is managed through an internal destructor list.
  * Objects with non-trivial destructors are registered in small batches (`DestructorChunk`)
@@ -32,15 +556,40 @@ inline constexpr size_t DESTRUCTOR_CHUNK_SIZE = 32;
  * @note All objects become invalid after `clear()` or move-assignment.
  */
 class ArenaV2 {
+    friend class ParentBlockSource;
+
 public:
+    /**
+     * @brief Position in the arena captured by `mark()`, restored by `rewind()`.
+     *
+     * Records the bump pointer (latest block index and its offset) and the destructor list position.
+     *
+     * @note A marker is invalidated by `clear()`, or by rewinding to an earlier marker.
+     */
+    class Marker {
+        friend class ArenaV2;
+
+        size_t mem_block_idx;
+        size_t offset;
+        void* destructor_chunk;
+        size_t n_destructors;
+        size_t run_count;
+#if ARENA_DEBUG
+        size_t n_redzones = 0;
+#endif
+
+        Marker(const size_t mem_block_idx, const size_t offset, void* destructor_chunk, const size_t n_destructors,
+               const size_t run_count) noexcept :
+            mem_block_idx(mem_block_idx), offset(offset), destructor_chunk(destructor_chunk),
+            n_destructors(n_destructors), run_count(run_count) {}
+    };
+
     /**
      * @brief Constructs a new arena with DEFAULT_BLOCK_SIZE.
      *
      * Constructs the first memory block immediately based on the default block size.
      */
-    explicit ArenaV2() : mem_block_latest_idx(0), block_size(DEFAULT_BLOCK_SIZE), arena_size(0) {
-        add_mem_block(DEFAULT_BLOCK_SIZE);
-    }
+    explicit ArenaV2() : ArenaV2(ArenaOptions{}) {}
 
     /**
     * @brief Constructs an arena with a specified initial block size.
@@ -49,8 +598,37 @@ public:
     *
     * @param size Minimum size (in bytes) of each newly allocated block.
     */
-    explicit ArenaV2(const size_t size) : mem_block_latest_idx(0), block_size(size), arena_size(0) {
-        add_mem_block(size);
+    explicit ArenaV2(const size_t size) : ArenaV2(ArenaOptions{.block_size = size}) {};
+
+    /**
+    * @brief Constructs an arena with a specified initial block size and growth policy.
+    *
+    * @param size Size (in bytes) of the first block.
+    * @param growth Policy deciding the size of subsequent blocks.
+    */
+    ArenaV2(const size_t size, const ArenaGrowthPolicy& growth)
+        : ArenaV2(ArenaOptions{.block_size = size, .growth = growth}) {};
+
+    /**
+    * @brief Constructs an arena from a set of options.
+    *
+    * Constructs the first block immediately based on `options.block_size`.
+    */
+    explicit ArenaV2(const ArenaOptions& options) :
+        mem_block_latest_idx(0),
+        block_size(options.block_size),
+        next_block_size(options.block_size),
+        growth(options.growth),
+        source(options.source),
+        arena_size(0),
+        leak_destructors(options.leak_destructors),
+        adaptive(options.adaptive),
+        retention(options.retention)
+#if ARENA_DEBUG
+        , debug_redzone(options.debug_redzone)
+#endif
+    {
+        add_mem_block(options.block_size);
     };
 
 
@@ -58,7 +636,7 @@ public:
      * @brief Destroys the arena and all allocated objects.
      */
     ~ArenaV2() {
-        clear();
+        destroy_objects();
     }
 
     ArenaV2(const ArenaV2&) = delete;
@@ -68,14 +646,37 @@ public:
     * @brief Moves ownership of memory blocks and destructor lists.
     */
     ArenaV2(ArenaV2&& other) noexcept :
+        block_cursor(other.block_cursor),
+        block_end(other.block_end),
         destructor_block_latest(other.destructor_block_latest),
+        epoch(other.epoch),
         mem_blocks(std::move(other.mem_blocks)),
         mem_block_latest_idx(other.mem_block_latest_idx),
         block_size(other.block_size),
-        arena_size(other.arena_size) {
+        next_block_size(other.next_block_size),
+        growth(other.growth),
+        source(other.source),
+        arena_size(other.arena_size),
+        leak_destructors(other.leak_destructors),
+        adaptive(other.adaptive),
+        high_water_mark(other.high_water_mark),
+        retention(other.retention),
+        idle_clears(other.idle_clears),
+        idle_window_blocks(other.idle_window_blocks)
+#if ARENA_DEBUG
+        , debug_redzone(other.debug_redzone)
+        , redzones(std::move(other.redzones))
+#endif
+#if ARENA_STATS
+        , stats(other.stats)
+#endif
+    {
+        other.block_cursor = nullptr;
+        other.block_end = nullptr;
         other.destructor_block_latest = nullptr;
         other.mem_block_latest_idx = 0;
         other.arena_size = 0;
+        other.epoch++;
     };
 
     /**
@@ -85,16 +686,38 @@ public:
      */
     ArenaV2& operator=(ArenaV2&& other) noexcept {
         if (&other != this) {
-            clear();
+            destroy_objects();
             this->block_size = other.block_size;
+            this->next_block_size = other.next_block_size;
+            this->growth = other.growth;
+            this->source = other.source;
             this->arena_size = other.arena_size;
+            this->leak_destructors = other.leak_destructors;
+            this->adaptive = other.adaptive;
+            this->high_water_mark = other.high_water_mark;
+            this->retention = other.retention;
+            this->idle_clears = other.idle_clears;
+            this->idle_window_blocks = other.idle_window_blocks;
+#if ARENA_DEBUG
+            this->debug_redzone = other.debug_redzone;
+            this->redzones = std::move(other.redzones);
+#endif
+#if ARENA_STATS
+            this->stats = other.stats;
+#endif
             this->destructor_block_latest = other.destructor_block_latest;
             this->mem_blocks = std::move(other.mem_blocks);
             this->mem_block_latest_idx = other.mem_block_latest_idx;
+            this->block_cursor = other.block_cursor;
+            this->block_end = other.block_end;
+            this->epoch = std::max(this->epoch, other.epoch) + 1;
 
+            other.block_cursor = nullptr;
+            other.block_end = nullptr;
             other.mem_block_latest_idx = 0;
             other.destructor_block_latest = nullptr;
             other.arena_size = 0;
+            other.epoch++;
         }
         return *this;
     }
@@ -112,160 +735,1285 @@ public:
     */
     template<typename T, typename ...Args>
     T* create(Args&& ... args) {
-        void* ptr = allocate(sizeof(T), alignof(T));
+        return create_at<T>(std::source_location{}, std::forward<Args>(args)...);
+    }
+
+    /**
+    * @brief `create()` recording `location` as the allocation site of the object for `ArenaProfiler`.
+    *
+    * @code
+    * auto* node = arena.create_at<Node>(std::source_location::current(), key);
+    * @endcode
+    */
+    template<typename T, typename ...Args>
+    T* create_at(const std::source_location& location, Args&& ... args) {
+        profile_allocation<T>(sizeof(T), location);
+        void* ptr = allocate_aligned<alignof(T)>(sizeof(T));
         T* obj = new (ptr) T(std::forward<Args>(args)...);
 
-        if constexpr (!std::is_trivially_destructible_v<T>) {
-            append_new_destructor(obj, &destruct<T>);
+        if constexpr (needs_destructor<T>) {
+            append_new_destructor<T>(obj, 1);
+        }
+
+        return obj;
+    }
+
+    /**
+    * @brief Constructs an object of type `T` within the arena without registering its destructor.
+    *
+    * The object is never destroyed by the arena, its memory is simply reclaimed by `clear()`.
+    * Use for objects whose destructor does nothing useful once the arena goes away.
+    *
+    * @return Pointer to the constructed object.
+    */
+    template<typename T, typename ...Args>
+    T* create_no_dtor(Args&& ... args) {
+        profile_allocation<T>(sizeof(T));
+        void* ptr = allocate_aligned<alignof(T)>(sizeof(T));
+        return new (ptr) T(std::forward<Args>(args)...);
+    }
+
+    /**
+    * @brief Constructs an array of `n` objects of type `T` within the arena.
+    *
+    * Every element is constructed from copies of `args`.
+    * A single destructor record covers the whole array, instead of one record per element.
+    *
+    * @tparam T Type of the elements.
+    * @tparam Args Constructor parameter types.
+    * @param n Number of elements.
+    * @param args Arguments passed to every element's constructor.
+    *
+    * @return Pointer to the first element, or nullptr if `n == 0`.
+    * @throws std::bad_array_new_length if `n * sizeof(T)` overflows.
+    */
+    template<typename T, typename ...Args>
+    T* create_array(const size_t n, const Args& ... args) {
+        T* arr = allocate_array<T>(n);
+        if (!arr) return nullptr;
+
+        size_t i = 0;
+        try {
+            for (; i < n; ++i) {
+                new (arr + i) T(args...);
+            }
+        } catch (...) {
+            destruct_n<T>(arr, i);
+            throw;
+        }
+
+        if constexpr (needs_destructor<T>) {
+            append_new_destructor<T>(arr, n);
+        }
+
+        return arr;
+    }
+
+    /**
+    * @brief Constructs an array of `n` default-initialised objects of type `T` within the arena.
+    *
+    * Like `new T[n]`, trivially default-constructible elements are left uninitialised,
+    * so the caller is expected to overwrite them.
+    * A single destructor record covers the whole array.
+    *
+    * @return Pointer to the first element, or nullptr if `n == 0`.
+    * @throws std::bad_array_new_length if `n * sizeof(T)` overflows.
+    */
+    template<typename T>
+    T* create_array_uninitialized(const size_t n) {
+        T* arr = allocate_array<T>(n);
+        if (!arr) return nullptr;
+
+        if constexpr (!std::is_trivially_default_constructible_v<T>) {
+            size_t i = 0;
+            try {
+                for (; i < n; ++i) {
+                    new (arr + i) T;
+                }
+            } catch (...) {
+                destruct_n<T>(arr, i);
+                throw;
+            }
+        }
+
+        if constexpr (needs_destructor<T>) {
+            append_new_destructor<T>(arr, n);
+        }
+
+        return arr;
+    }
+
+    /**
+    * @brief Clears the arena: destroys registered objects and resets offsets.
+    *
+    * All allocated objects become invalid. Memory blocks are retained and refilled in order
+    * by subsequent allocations before any new block is requested.
+    *
+    * @post mem_block_latest_idx == 0
+    * @post All destructors have been invoked.
+    */
+    void clear() {
+        destroy_objects();
+        if (retention.idle_clears) [[unlikely]] release_idle_blocks();
+        if (adaptive.enabled) [[unlikely]] retune_blocks();
+        reset_offsets();
+    }
+
+    /**
+    * @brief Clears the arena and returns every block but the first to its source.
+    *
+    * Leaves the arena with the footprint of a freshly constructed one, and restarts the growth policy.
+    * A first block more than twice `get_single_block_size()` (e.g. coalesced by adaptive sizing) is replaced too.
+    */
+    void clear_and_release() {
+        destroy_objects();
+        record_peak();
+
+        if (!mem_blocks.empty()) {
+            mem_blocks.erase(mem_blocks.begin() + 1, mem_blocks.end());
+            if (mem_blocks.front().source && mem_blocks.front().size > 2 * block_size) {
+                mem_blocks.clear();
+                load_latest_block();
+                arena_size = 0;
+                mem_blocks.emplace_back(block_size, source);
+            }
+            arena_size = mem_blocks.front().size;
+        }
+
+        next_block_size = block_size;
+        idle_clears = 0;
+        idle_window_blocks = 0;
+        reset_offsets();
+    }
+
+    /**
+    * @brief Returns retained blocks to their source until the arena holds at most `keep_bytes`.
+    *
+    * Only blocks the arena has not entered since the last `clear()` are released, newest first,
+    * so live allocations are never affected and calling `trim()` right after `clear()` frees the most.
+    * Blocks kept are refilled in order as usual.
+    *
+    * @param keep_bytes Budget (in bytes) for the blocks the arena keeps.
+    *
+    * @return Bytes returned to the block sources.
+    */
+    size_t trim(const size_t keep_bytes = 0) noexcept {
+        return release_blocks_from(mem_block_latest_idx + 1, keep_bytes);
+    }
+
+    /**
+    * @brief Creates a child arena whose blocks are borrowed from this arena.
+    *
+    * See `ChildArenaV2`. The child must be destroyed before this arena.
+    *
+    * @param size Size (in bytes) of the child's first block, this arena's block size by default.
+    */
+    [[nodiscard]] ChildArenaV2 make_child();
+    [[nodiscard]] ChildArenaV2 make_child(size_t size);
+
+    /**
+    * @brief Clears the arena, running destructors on `n_threads` threads.
+    *
+    * Registered objects are split into equal slices, runs of one type are split across slices too,
+    * and each slice is destroyed on its own thread, the calling thread taking the first one.
+    * Arenas with fewer than `PARALLEL_CLEAR_MIN_OBJECTS_PER_THREAD` objects per thread use fewer threads,
+    * down to a plain `clear()`.
+    *
+    * @param n_threads Maximum number of threads, including the caller.
+    *
+    * @warning Destruction order is unspecified. Only use when no destructor depends on another object of the arena.
+    */
+    void clear_parallel(const size_t n_threads = std::thread::hardware_concurrency()) {
+        std::vector<DestructorNode> runs;
+        size_t n_objects = 0;
+        for (const DestructorChunk* curr = destructor_block_latest; curr; curr = curr->prev) {
+            for (size_t i = curr->n_nodes; i > 0; i--) {
+                runs.push_back(curr->nodes[i - 1]);
+                n_objects += curr->nodes[i - 1].count;
+            }
+        }
+
+        const size_t n_slices = std::min(std::max<size_t>(n_threads, 1), n_objects / PARALLEL_CLEAR_MIN_OBJECTS_PER_THREAD);
+        if (n_slices <= 1) {
+            clear();
+            return;
+        }
+
+        const size_t slice_size = (n_objects + n_slices - 1) / n_slices;
+        std::vector<std::thread> workers;
+        workers.reserve(n_slices - 1);
+
+        for (size_t slice = 1; slice < n_slices; ++slice) {
+            const size_t first = slice * slice_size;
+            const size_t last = std::min(first + slice_size, n_objects);
+            try {
+                workers.emplace_back([&runs, first, last] { destroy_slice(runs, first, last); });
+            } catch (const std::system_error&) {
+                destroy_slice(runs, first, last);
+            }
+        }
+
+        destroy_slice(runs, 0, slice_size);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        destructor_block_latest = nullptr;
+        check_redzones(0);
+        if (retention.idle_clears) [[unlikely]] release_idle_blocks();
+        if (adaptive.enabled) [[unlikely]] retune_blocks();
+        reset_offsets();
+    }
+
+    /**
+    * @brief Clears the arena, handing destructors and used blocks to a background thread.
+    *
+    * The arena is immediately reusable: it keeps the retained blocks it has not entered since the last clear,
+    * or gets a fresh block of `get_single_block_size()` bytes, while the background thread destroys
+    * every registered object and returns the used blocks to their source.
+    * Arenas whose first block is borrowed (`InlineArenaV2`), or whose used blocks come from a source
+    * that is not `thread_agnostic` (`ParentBlockSource`, `BlockCache`), clear synchronously instead.
+    *
+    * @return Future ready once every object is destroyed and every used block released.
+    * If the reclaimer thread cannot be started, both happen before returning.
+    *
+    * @note As for any `std::async` future, discarding or destroying the future waits for the reclaimer.
+    */
+    [[nodiscard]] std::future<void> clear_async() {
+        if (mem_blocks.empty() || !used_blocks_thread_agnostic()) {
+            clear();
+            return ready_future();
+        }
+
+        check_redzones(0);
+        if (retention.idle_clears) [[unlikely]] release_idle_blocks();
+        record_peak();
+        sync_latest_offset();
+
+        // shared with the reclaimer, so the blocks stay owned here if the thread cannot be started.
+        auto used = std::make_shared<std::vector<MemBlock>>();
+        size_t used_bytes = 0;
+        used->reserve(mem_block_latest_idx + 1);
+        for (size_t idx = 0; idx <= mem_block_latest_idx; ++idx) {
+            used_bytes += mem_blocks[idx].offset;
+            used->push_back(std::move(mem_blocks[idx]));
+        }
+        mem_blocks.erase(mem_blocks.begin(), mem_blocks.begin() + static_cast<ptrdiff_t>(mem_block_latest_idx + 1));
+        DestructorChunk* chunks = destructor_block_latest;
+
+        std::future<void> reclaimed;
+        try {
+            reclaimed = std::async(std::launch::async, [chunks, used] {
+                destroy_chunks(chunks);
+                used->clear();
+            });
+        } catch (...) {
+            destroy_chunks(chunks);
+            used->clear();
+        }
+
+        destructor_block_latest = nullptr;
+        arena_size = 0;
+        for (const MemBlock& mb : mem_blocks) {
+            arena_size += mb.size;
+        }
+        reset_offsets();
+
+        if (!adaptive.enabled) {
+            if (mem_blocks.empty()) add_mem_block(block_size);
+        } else {
+            const size_t target = update_high_water_mark(used_bytes);
+            if (mem_blocks.empty()) add_mem_block(target);
+            else coalesce_blocks(target);
+        }
+
+        return reclaimed.valid() ? std::move(reclaimed) : ready_future();
+    }
+
+    /**
+     * @brief Allocates uninitialised storage for `n` objects of type `T`, aligned at compile time.
+     *
+     * No destructor is registered, the caller constructs and destroys the objects.
+     *
+     * @return Pointer to the storage, or nullptr if `n == 0`.
+     * @throws std::bad_array_new_length if `n * sizeof(T)` overflows.
+     */
+    template<typename T>
+    [[nodiscard]] T* allocate(const size_t n = 1) {
+        return allocate_array<T>(n);
+    }
+
+    /**
+     * @brief Copies `str` into the arena, followed by a NUL terminator.
+     *
+     * The bytes are bump-allocated with no alignment and no destructor record,
+     * making this the cheapest way to keep a string alive for the arena's lifetime.
+     *
+     * @return View of the copy, valid until `clear()`.
+     */
+    [[nodiscard]] std::string_view copy_string(const std::string_view str) noexcept {
+        profile_allocation<char>(str.size() + 1);
+        char* chars = static_cast<char*>(allocate_aligned<1>(str.size() + 1));
+        if (!str.empty()) std::memcpy(chars, str.data(), str.size());
+        chars[str.size()] = '\0';
+        return {chars, str.size()};
+    }
+
+    /**
+     * @brief Allocates raw memory with user-specified alignment.
+     *
+     * This function is primarily used to work with STL allocator requirements.
+     *
+     * @param size Number of bytes to allocate.
+     * @param align Required alignment.
+     *
+     * @return Pointer to an aligned memory region within the arena.
+     */
+    void* allocate_raw(const size_t size, const size_t align) noexcept {
+        profile_raw_allocation(size, align);
+        return allocate(size, align);
+    }
+
+    /**
+     * @brief Returns memory to the arena if it is the most recent allocation, otherwise does nothing.
+     *
+     * Rolls the bump pointer of the latest block back to `ptr`, so a stack-like allocate/deallocate
+     * pattern reuses the same bytes.
+     *
+     * @param ptr Pointer returned by `allocate_raw()`.
+     * @param size Size (in bytes) `ptr` was allocated with.
+     *
+     * @return Whether the memory was returned.
+     * @warning Must not be used on objects from `create`, their destructors stay registered.
+     * @warning `ptr` must have been allocated since the last `clear()` or `rewind()`: a stale pointer can end exactly
+     * where the new cycle's latest allocation does. Handles that may outlive a clear use the overload taking an epoch.
+     */
+    bool deallocate_raw(void* ptr, const size_t size) noexcept {
+        char* p = static_cast<char*>(ptr);
+
+        if (p + size + redzone_size() != block_cursor || p < mem_blocks[mem_block_latest_idx].buffer) return false;
+
+        record_peak();
+#if ARENA_DEBUG
+        check_redzones(redzones.size() - (debug_redzone ? 1 : 0));
+        ARENA_POISON(p, static_cast<size_t>(block_cursor - p));
+#endif
+        block_cursor = p;
+        return true;
+    }
+
+    /**
+     * @brief `deallocate_raw(ptr, size)` for a pointer allocated in `allocated_epoch`, refused once the epoch is over.
+     *
+     * @param allocated_epoch `get_epoch()` when `ptr` was allocated, or last grown in place.
+     */
+    bool deallocate_raw(void* ptr, const size_t size, const uint64_t allocated_epoch) noexcept {
+        return allocated_epoch == epoch && deallocate_raw(ptr, size);
+    }
+
+    /**
+     * @brief Grows (or shrinks) an allocation in place if it is the most recent allocation and the block has room.
+     *
+     * @param ptr Pointer returned by `allocate_raw()`.
+     * @param old_size Size (in bytes) `ptr` currently spans.
+     * @param new_size Size (in bytes) `ptr` should span.
+     *
+     * @return Whether the allocation now spans `new_size` bytes, `ptr` is unchanged either way.
+     * @warning As for `deallocate_raw`, `ptr` must have been allocated since the last `clear()` or `rewind()`.
+     */
+    bool try_extend(void* ptr, const size_t old_size, const size_t new_size) noexcept {
+        char* p = static_cast<char*>(ptr);
+
+        if (p + old_size + redzone_size() != block_cursor || p < mem_blocks[mem_block_latest_idx].buffer) return false;
+        if (new_size + redzone_size() > static_cast<size_t>(block_end - p)) return false;
+
+        if (new_size < old_size) {
+            record_peak();
+        }
+#if ARENA_STATS
+        if (new_size > old_size) stats.bytes_requested += new_size - old_size;
+#endif
+#if ARENA_DEBUG
+        check_redzones(redzones.size() - (debug_redzone ? 1 : 0));
+        ARENA_POISON(p, old_size + debug_redzone);
+        ARENA_UNPOISON(p, new_size);
+        place_redzone(p + new_size);
+#endif
+        block_cursor = p + new_size + redzone_size();
+        return true;
+    }
+
+    /**
+     * @brief `try_extend(ptr, old_size, new_size)` for a pointer allocated in `allocated_epoch`, refused once the epoch is over.
+     */
+    bool try_extend(void* ptr, const size_t old_size, const size_t new_size, const uint64_t allocated_epoch) noexcept {
+        return allocated_epoch == epoch && try_extend(ptr, old_size, new_size);
+    }
+
+    /**
+     * @brief Generation of the arena's memory, advanced by every `clear()`, `rewind()` and move.
+     *
+     * Memory handed out in one epoch is reused by the next. Containers that may outlive a clear record the epoch
+     * of their allocation and pass it back to `deallocate_raw()` and `try_extend()`, which then refuse stale pointers.
+     */
+    [[nodiscard]] uint64_t get_epoch() const noexcept {return epoch;}
+
+    /**
+     * @brief Resizes an allocation, in place when possible, otherwise by copying its bytes to a new allocation.
+     *
+     * @param ptr Pointer returned by `allocate_raw()`, or nullptr.
+     * @param old_size Size (in bytes) `ptr` currently spans.
+     * @param new_size Size (in bytes) requested.
+     * @param align Alignment `ptr` was allocated with.
+     *
+     * @return Pointer to `new_size` bytes holding the first `min(old_size, new_size)` bytes of `ptr`.
+     * @warning Contents are moved with `memcpy`, only use with trivially copyable data.
+     */
+    void* reallocate(void* ptr, const size_t old_size, const size_t new_size, const size_t align) noexcept {
+        if (ptr && try_extend(ptr, old_size, new_size)) {
+            return ptr;
+        }
+
+        profile_raw_allocation(new_size, align);
+        void* p = allocate(new_size, align);
+        if (ptr) {
+            std::memcpy(p, ptr, std::min(old_size, new_size));
+        }
+        return p;
+    }
+
+    /**
+     * @brief Captures the current position of the arena.
+     *
+     * @return Marker that `rewind()` can roll the arena back to.
+     */
+    [[nodiscard]] Marker mark() const noexcept {
+        const size_t n_destructors = destructor_block_latest ? destructor_block_latest->n_nodes : 0;
+        Marker marker{
+            mem_block_latest_idx,
+            latest_offset(),
+            destructor_block_latest,
+            n_destructors,
+            n_destructors ? destructor_block_latest->nodes[n_destructors - 1].count : 0
+        };
+#if ARENA_DEBUG
+        marker.n_redzones = redzones.size();
+#endif
+        return marker;
+    }
+
+    /**
+     * @brief Rolls the arena back to a previously captured marker.
+     *
+     * Destroys only the objects registered after `marker`, in reverse order like `clear()`,
+     * then restores the bump pointer. Objects allocated before `marker` remain valid.
+     * Blocks entered after `marker` are retained and reused.
+     *
+     * @param marker Marker returned by `mark()` on this arena since the last `clear()`.
+     */
+    void rewind(const Marker& marker) {
+        record_peak();
+        epoch++;
+        auto* const marker_chunk = static_cast<DestructorChunk*>(marker.destructor_chunk);
+
+        DestructorChunk* curr = destructor_block_latest;
+        while (curr != marker_chunk) {
+            for (size_t i = curr->n_nodes; i > 0; i--) {
+                curr->nodes[i - 1].fn(curr->nodes[i - 1].obj, curr->nodes[i - 1].count);
+            }
+            curr = curr->prev;
+        }
+
+        if (marker_chunk) {
+            for (size_t i = marker_chunk->n_nodes; i > marker.n_destructors; i--) {
+                marker_chunk->nodes[i - 1].fn(marker_chunk->nodes[i - 1].obj, marker_chunk->nodes[i - 1].count);
+            }
+            marker_chunk->n_nodes = marker.n_destructors;
+
+            // the last run may have been extended after the marker, destroy only its tail.
+            if (marker.n_destructors) {
+                DestructorNode& run = marker_chunk->nodes[marker.n_destructors - 1];
+                if (run.count > marker.run_count) {
+                    run.fn(static_cast<char*>(run.obj) + marker.run_count * run.stride, run.count - marker.run_count);
+                    run.count = marker.run_count;
+                }
+            }
+        }
+
+        destructor_block_latest = marker_chunk;
+
+#if ARENA_DEBUG
+        check_redzones(marker.n_redzones);
+        sync_latest_offset();
+        for (size_t idx = marker.mem_block_idx; idx <= mem_block_latest_idx; ++idx) {
+            const size_t first = idx == marker.mem_block_idx ? marker.offset : 0;
+            ARENA_POISON(mem_blocks[idx].buffer + first, mem_blocks[idx].offset - first);
+        }
+#endif
+        for (size_t idx = marker.mem_block_idx + 1; idx <= mem_block_latest_idx; ++idx) {
+            mem_blocks[idx].offset = 0;
+        }
+
+        mem_blocks[marker.mem_block_idx].offset = marker.offset;
+        mem_block_latest_idx = marker.mem_block_idx;
+        load_latest_block();
+    }
+
+
+    /**
+     * @brief Snapshot of the allocation counters.
+     *
+     * @return Counters since construction or `reset_stats()`, all zero unless `ARENA_STATS` is enabled.
+     */
+    [[nodiscard]] ArenaStats get_stats() const noexcept {
+#if ARENA_STATS
+        ArenaStats snapshot = stats;
+        snapshot.bytes_in_use = bytes_in_use();
+        snapshot.peak_bytes_in_use = std::max(snapshot.peak_bytes_in_use, snapshot.bytes_in_use);
+        snapshot.bytes_consumed = snapshot.bytes_requested + snapshot.padding_bytes;
+        snapshot.bytes_reserved = arena_size;
+        return snapshot;
+#else
+        return ArenaStats{};
+#endif
+    }
+
+    /**
+     * @brief Zeroes the accumulated counters, the peak restarts from the current usage.
+     */
+    void reset_stats() noexcept {
+#if ARENA_STATS
+        stats = ArenaStats{};
+        stats.peak_bytes_in_use = bytes_in_use();
+#endif
+    }
+
+    /**
+     * @brief Converts a pointer into this arena into a position-independent `arena_ptr`.
+     *
+     * The latest block is checked first, so converting a fresh allocation is O(1), older blocks are searched.
+     * Like the pointer itself, the result is invalidated by `clear()`.
+     *
+     * @return `arena_ptr` to `ptr`, null if `ptr` is null or not inside one of the arena's blocks.
+     */
+    template<typename T>
+    [[nodiscard]] arena_ptr<T> to_arena_ptr(T* ptr) const noexcept {
+        if (!ptr || mem_blocks.empty()) return nullptr;
+
+        const auto addr = reinterpret_cast<uintptr_t>(ptr);
+        for (size_t idx = mem_block_latest_idx + 1; idx > 0; idx--) {
+            const auto base = reinterpret_cast<uintptr_t>(mem_blocks[idx - 1].buffer);
+            if (addr >= base && addr - base < mem_blocks[idx - 1].size) {
+                return arena_ptr<T>(idx - 1, addr - base);
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Converts an array in this arena into a position-independent `arena_span`.
+     */
+    template<typename T>
+    [[nodiscard]] arena_span<T> to_arena_span(T* data, const size_t size) const noexcept {
+        return arena_span<T>{to_arena_ptr(data), size};
+    }
+
+    /**
+     * @return Object `ptr` refers to, nullptr if `ptr` is null.
+     */
+    template<typename T>
+    [[nodiscard]] T* resolve(const arena_ptr<T> ptr) const noexcept {
+        if (!ptr) return nullptr;
+        return static_cast<T*>(static_cast<void*>(mem_blocks[ptr.block_index()].buffer + ptr.block_offset()));
+    }
+
+    /**
+     * @return Array `span` refers to.
+     */
+    template<typename T>
+    [[nodiscard]] std::span<T> resolve(const arena_span<T>& span) const noexcept {
+        return {resolve(span.data), span.size};
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    /**
+     * @brief Writes the used bytes of every block to `fd`, to be mapped back by `MappedArena`.
+     *
+     * Objects reachable from the snapshot must be trivially copyable and link to each other with
+     * `arena_ptr`/`arena_span` instead of raw pointers, the bytes are written verbatim and never fixed up.
+     * The file is only readable by builds sharing this one's ABI (endianness, type layouts).
+     *
+     * @param fd File descriptor to write to, at its current position. The snapshot should start the file.
+     * @param root Object the reader starts from, returned by `MappedArena::root()`.
+     *
+     * @return Whether the whole snapshot was written.
+     */
+    template<typename T = void>
+    bool snapshot(const int fd, const arena_ptr<T> root = {}) const noexcept {
+        if (mem_blocks.empty()) return false;
+
+        const size_t n_blocks = mem_block_latest_idx + 1;
+        std::vector<ArenaSnapshotBlock> records(n_blocks);
+
+        uint64_t pos = sizeof(ArenaSnapshotHeader) + n_blocks * sizeof(ArenaSnapshotBlock);
+        for (size_t idx = 0; idx < n_blocks; ++idx) {
+            const uint64_t misalignment = reinterpret_cast<uintptr_t>(mem_blocks[idx].buffer) & (ARENA_SNAPSHOT_ALIGNMENT - 1);
+            pos += (misalignment - pos) & (ARENA_SNAPSHOT_ALIGNMENT - 1);
+            records[idx].file_offset = pos;
+            records[idx].size = idx == mem_block_latest_idx ? latest_offset() : mem_blocks[idx].offset;
+            pos += records[idx].size;
+        }
+
+        ArenaSnapshotHeader header{};
+        std::memcpy(header.magic, ARENA_SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = ARENA_SNAPSHOT_VERSION;
+        header.n_blocks = static_cast<uint32_t>(n_blocks);
+        header.root = root.raw();
+        header.file_size = pos;
+
+        if (!write_all(fd, &header, sizeof(header))) return false;
+        if (!write_all(fd, records.data(), n_blocks * sizeof(ArenaSnapshotBlock))) return false;
+
+        static constexpr char zeros[ARENA_SNAPSHOT_ALIGNMENT]{};
+        pos = sizeof(ArenaSnapshotHeader) + n_blocks * sizeof(ArenaSnapshotBlock);
+        for (size_t idx = 0; idx < n_blocks; ++idx) {
+            if (!write_all(fd, zeros, records[idx].file_offset - pos)) return false;
+            if (!write_all(fd, mem_blocks[idx].buffer, records[idx].size)) return false;
+            pos = records[idx].file_offset + records[idx].size;
+        }
+        return true;
+    }
+#endif
+
+    /** @return Total bytes of all allocated memory blocks. */
+    [[nodiscard]] size_t get_arena_size() const {return arena_size;}
+
+    /** @return Default bytes of a newly created memory block. */
+    [[nodiscard]] size_t get_single_block_size() const {return block_size;}
+
+    /** @return Bytes of the next block the growth policy will request. */
+    [[nodiscard]] size_t get_next_block_size() const {return next_block_size;}
+
+    /** @return Source the arena obtains block memory from. */
+    [[nodiscard]] BlockSource* get_block_source() const {return source;}
+
+    /** @return Usage the adaptive sizing currently plans for, 0 unless `ArenaOptions::adaptive` is enabled. */
+    [[nodiscard]] size_t get_high_water_mark() const {return high_water_mark;}
+
+    /** @return Whether destructor registration is disabled for this arena. */
+    [[nodiscard]] bool get_leak_destructors() const {return leak_destructors;}
+
+    /** @return Number of memory blocks allocated so far. */
+    [[nodiscard]] size_t get_number_of_allocated_blocks() const {return mem_blocks.size();}
+
+private:
+    /**
+     * Whether objects of type T get a destructor record.
+     */
+    template<typename T>
+    static constexpr bool needs_destructor = !std::is_trivially_destructible_v<T> && !arena_skip_destroy_v<T>;
+
+    /**
+     * @brief Destroys `n` contiguous objects of type T, last to first.
+     *
+     * Pointers are stored as `void*` internally, so this re-casts and calls the destructor manually.
+     * Primary purpose of this template is to allow for compile-time dispatch, reducing the need to maintain vtable.
+     * Arrays are torn down in a tight loop with a direct destructor call the compiler can inline.
+     */
+    template<typename T>
+    static void destruct_n(void* p, const size_t n) noexcept {
+        T* arr = static_cast<T*>(p);
+        for (size_t i = n; i > 0; i--) {
+            arr[i - 1].~T();
+        }
+    }
+
+    /**
+     * @brief Node storing a destructor function and a run of `count` contiguous objects it destroys.
+     *
+     * Objects of the same type created back to back are coalesced into one run,
+     * so teardown makes one indirect call per run rather than per object.
+     */
+    struct DestructorNode {
+        void (*fn)(void*, size_t);
+        void* obj;
+        size_t count;
+        size_t stride;
+    };
+
+    /**
+    * @brief Chunk of destructor records, maintained as a linked list.
+    *
+    * Chunks are allocated inside the arena and chained backwards.
+    * Deallocation is also conducted backwards to align to lifetime semantics.
+    */
+    struct DestructorChunk {
+        DestructorNode nodes[DESTRUCTOR_CHUNK_SIZE]{};
+        size_t n_nodes = 0;
+        DestructorChunk* prev{};
+    };
+
+    /**
+     * @brief Runs every destructor of a chunk list, latest first.
+     */
+    static void destroy_chunks(const DestructorChunk* curr) noexcept {
+        while (curr) {
+            for (size_t i = curr->n_nodes; i > 0; i--) {
+                curr->nodes[i - 1].fn(curr->nodes[i - 1].obj, curr->nodes[i - 1].count);
+            }
+            curr = curr->prev;
+        }
+    }
+
+    /**
+     * @brief Destroys objects `[first, last)` of `runs`, counting objects across runs.
+     */
+    static void destroy_slice(const std::vector<DestructorNode>& runs, const size_t first, const size_t last) noexcept {
+        size_t pos = 0;
+        for (const DestructorNode& run : runs) {
+            const size_t lo = std::max(first, pos);
+            const size_t hi = std::min(last, pos + run.count);
+            if (lo < hi) {
+                run.fn(static_cast<char*>(run.obj) + (lo - pos) * run.stride, hi - lo);
+            }
+            pos += run.count;
+            if (pos >= last) return;
+        }
+    }
+
+    /**
+     * @brief Runs every registered destructor and forgets the records, leaving the blocks untouched.
+     */
+    void destroy_objects() noexcept {
+        destroy_chunks(destructor_block_latest);
+        destructor_block_latest = nullptr;
+        check_redzones(0);
+    }
+
+    /**
+     * @brief Rewinds every block to offset 0 and restarts allocation from the first one.
+     */
+    void reset_offsets() noexcept {
+        record_peak();
+        epoch++;
+        for (MemBlock& mb : mem_blocks) {
+            if (mb.source && mb.source->discard_fn) [[unlikely]] mb.source->discard(mb.buffer, mb.size);
+            ARENA_POISON(mb.buffer, mb.size);
+            mb.offset = 0;
+        }
+
+        mem_block_latest_idx = 0;
+        load_latest_block();
+    }
+
+    /**
+     * @brief Represents one contiguous memory block owned by the arena.
+     *
+     * Memory is obtained from, and returned to, the block source it was created with.
+     * A block without a source borrows its buffer (e.g. `InlineArenaV2`'s inline storage) and never frees it.
+     */
+    struct MemBlock {
+        char* buffer;
+        size_t size;
+        size_t offset;
+        BlockSource* source;
+
+        MemBlock(const size_t size, BlockSource* source): buffer(nullptr), size(size), offset(0), source(source) {
+            buffer = static_cast<char*>(source->allocate(this->size));
+            if (!buffer) throw std::bad_alloc();
+            ARENA_POISON(buffer, this->size);
+        }
+
+        MemBlock(char* buffer, const size_t size) noexcept : buffer(buffer), size(size), offset(0), source(nullptr) {
+            ARENA_POISON(buffer, size);
+        }
+
+        MemBlock(char* buffer, const size_t size, BlockSource* source) noexcept :
+            buffer(buffer), size(size), offset(0), source(source) {
+            ARENA_POISON(buffer, size);
+        }
+
+        ~MemBlock() {
+            release();
+        }
+
+        MemBlock(MemBlock&& other) noexcept : buffer(other.buffer), size(other.size), offset(other.offset), source(other.source) {
+            other.buffer = nullptr;
+            other.size = 0;
+            other.offset = 0;
+        }
+
+        MemBlock& operator=(MemBlock&& other) noexcept {
+            if (this != &other) {
+                release();
+                buffer = other.buffer;
+                size = other.size;
+                offset = other.offset;
+                source = other.source;
+                other.buffer = nullptr;
+                other.size = 0;
+                other.offset = 0;
+            }
+            return *this;
+        }
+
+        MemBlock(const MemBlock&) = delete;
+        MemBlock& operator=(const MemBlock&) = delete;
+
+        /**
+         * @brief Returns the buffer to its source, unpoisoned since the source (or the borrowed storage's owner) reuses it.
+         */
+        void release() noexcept {
+            if (!buffer) return;
+            ARENA_UNPOISON(buffer, size);
+            if (source) source->deallocate(buffer, size);
+        }
+    };
+
+    /**
+     * @brief Allocator of the `mem_blocks` vector.
+     *
+     * Serves the first `n_inline_slots` records from storage embedded in `InlineArenaV2`,
+     * so a small arena makes no heap allocation until it spills. Without inline slots it is a plain heap allocator.
+     * `mem_blocks` only ever grows, so the inline slots are never requested twice at once.
+     */
+    template<typename T>
+    struct BlockListAllocator {
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        void* inline_slots = nullptr;
+        size_t n_inline_slots = 0;
+
+        BlockListAllocator() noexcept = default;
+        BlockListAllocator(void* inline_slots, const size_t n_inline_slots) noexcept :
+            inline_slots(inline_slots), n_inline_slots(n_inline_slots) {}
+
+        template<typename U>
+        explicit BlockListAllocator(const BlockListAllocator<U>& other) noexcept :
+            inline_slots(other.inline_slots), n_inline_slots(other.n_inline_slots) {}
+
+        T* allocate(const size_t n) {
+            if (n <= n_inline_slots) return static_cast<T*>(inline_slots);
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* ptr, size_t) noexcept {
+            if (ptr != inline_slots) ::operator delete(ptr);
+        }
+
+        template<typename U>
+        bool operator==(const BlockListAllocator<U>& other) const noexcept {
+            return inline_slots == other.inline_slots;
+        }
+    };
+
+    /**
+     * Bump pointer of the latest block, kept outside `mem_blocks` so the fast path never indexes the vector.
+     * While a block is the latest, its `MemBlock::offset` is stale and `block_cursor` is authoritative,
+     * `sync_latest_offset()` writes it back before the arena moves to another block.
+     */
+    char* block_cursor = nullptr;
+
+    /**
+     * End of the latest block.
+     */
+    char* block_end = nullptr;
+
+    /**
+     * Tracks the location to add the latest destructor block as well as to remove destructor blocks.
+     */
+    DestructorChunk* destructor_block_latest = nullptr;
+
+    /**
+     * See `get_epoch()`.
+     */
+    uint64_t epoch = 0;
+
+    /**
+     * Tracks memory blocks
+     */
+    std::vector<MemBlock, BlockListAllocator<MemBlock>> mem_blocks;
+
+    /**
+     * Tracks index of the latest memory block.
+     * Pointers are not used to avoid dangling references if vector resizes.
+     */
+    size_t mem_block_latest_idx;
+
+    /**
+     * Size of the first memory block.
+     */
+    size_t block_size;
+
+    /**
+     * Minimal size of the next memory block, advanced by `growth` every time a block is added.
+     */
+    size_t next_block_size;
+
+    /**
+     * Policy used to compute `next_block_size`.
+     */
+    ArenaGrowthPolicy growth;
+
+    /**
+     * Where block memory comes from.
+     */
+    BlockSource* source;
+
+    /**
+     * Current size of the arena.
+     */
+    size_t arena_size;
+
+    /**
+     * Skips destructor registration, see `ArenaOptions::leak_destructors`.
+     */
+    bool leak_destructors;
+
+    /**
+     * Auto-tuning configuration, see `ArenaOptions::adaptive`.
+     */
+    ArenaAdaptiveSizing adaptive;
+
+    /**
+     * Decayed peak of the bytes used per `clear()` cycle, driving adaptive sizing.
+     */
+    size_t high_water_mark = 0;
+
+    /**
+     * @brief Folds the usage of a finished cycle into the high-water mark.
+     *
+     * @return Size (in bytes) the blocks of the next cycle should add up to.
+     */
+    size_t update_high_water_mark(const size_t used) noexcept {
+        if (used >= high_water_mark) {
+            high_water_mark = used;
+        } else {
+            high_water_mark -= static_cast<size_t>(static_cast<double>(high_water_mark - used) * adaptive.decay);
+        }
+
+        const auto target = static_cast<size_t>(static_cast<double>(high_water_mark) * std::max(adaptive.headroom, 1.0));
+        return std::max(target, block_size);
+    }
+
+    /**
+     * @brief Replaces the owned blocks with a single block of `target` bytes, if the current ones fit badly.
+     *
+     * Blocks are rebuilt when there are several of them, or the single one is either smaller than the high-water mark
+     * or more than twice the target. A borrowed first block (`InlineArenaV2`) is kept and counts towards `target`.
+     * Every block must be empty.
+     */
+    void coalesce_blocks(const size_t target) noexcept {
+        const size_t first_owned = !mem_blocks.empty() && !mem_blocks.front().source ? 1 : 0;
+        const size_t borrowed = first_owned ? mem_blocks.front().size : 0;
+        const size_t n_owned = mem_blocks.size() - first_owned;
+
+        if (n_owned == 0 && high_water_mark <= borrowed) return;
+
+        const size_t owned_target = std::max(target > borrowed ? target - borrowed : 0, block_size);
+        const size_t owned_needed = high_water_mark > borrowed ? high_water_mark - borrowed : 0;
+
+        if (n_owned == 1) {
+            const size_t owned = mem_blocks.back().size;
+            if (owned >= owned_needed && owned <= 2 * owned_target) return;
+        }
+
+        for (size_t idx = first_owned; idx < mem_blocks.size(); ++idx) {
+            arena_size -= mem_blocks[idx].size;
+        }
+        mem_blocks.erase(mem_blocks.begin() + static_cast<ptrdiff_t>(first_owned), mem_blocks.end());
+        mem_blocks.emplace_back(owned_target, source);
+        arena_size += mem_blocks.back().size;
+        mem_block_latest_idx = 0;
+        load_latest_block();
+    }
+
+    /**
+     * @brief Adaptive step of `clear()`: records the finished cycle's usage and resizes the blocks for the next one.
+     */
+    void retune_blocks() noexcept {
+        if (mem_blocks.empty()) return;
+
+        record_peak();
+        coalesce_blocks(update_high_water_mark(bytes_in_use()));
+    }
+
+    /**
+     * Retention configuration, see `ArenaOptions::retention`.
+     */
+    ArenaRetentionPolicy retention;
+
+    /**
+     * Clears counted in the current idle window.
+     */
+    size_t idle_clears = 0;
+
+    /**
+     * Most blocks entered by any cycle of the current idle window.
+     */
+    size_t idle_window_blocks = 0;
+
+#if ARENA_DEBUG
+    /**
+     * Canary bytes after every allocation, see `ArenaOptions::debug_redzone`.
+     */
+    size_t debug_redzone = 0;
+
+    /**
+     * Redzones of the live allocations, in allocation order.
+     */
+    std::vector<char*> redzones;
+
+    /**
+     * Writes the canary ASan-poisoned memory, so the write itself must not be instrumented.
+     */
+    __attribute__((no_sanitize_address))
+    void place_redzone(char* redzone) {
+        if (!debug_redzone) return;
+        for (size_t i = 0; i < debug_redzone; ++i) {
+            redzone[i] = static_cast<char>(ARENA_DEBUG_CANARY);
+        }
+        ARENA_POISON(redzone, debug_redzone);
+        redzones.push_back(redzone);
+    }
+
+    /**
+     * @brief Verifies the canaries of redzones from index `first` onwards, then forgets them.
+     *
+     * An overwritten canary means an allocation was written past its end, reported by aborting.
+     */
+    __attribute__((no_sanitize_address))
+    void check_redzones(const size_t first) noexcept {
+        for (size_t idx = first; idx < redzones.size(); ++idx) {
+            for (size_t i = 0; i < debug_redzone; ++i) {
+                if (static_cast<unsigned char>(redzones[idx][i]) != ARENA_DEBUG_CANARY) [[unlikely]] {
+                    std::fprintf(stderr, "ArenaV2: redzone at %p overwritten, an allocation was written past its end\n",
+                                 static_cast<void*>(redzones[idx]));
+                    std::abort();
+                }
+            }
         }
-
-        return obj;
+        redzones.resize(first);
     }
+#else
+    static void check_redzones(size_t) noexcept {}
+#endif
 
     /**
-    * @brief Clears the arena: destroys registered objects and resets offsets.
-    *
-    * All allocated objects become invalid. Memory blocks are retained for reuse.
-    *
-    * @post mem_block_latest_idx == 0
-    * @post All destructors have been invoked.
-    */
-    void clear() {
-        DestructorChunk* curr = destructor_block_latest;
-        while (curr) {
-            for (size_t i = curr->n_nodes; i > 0; i--) {
-                curr->nodes[i - 1].fn(curr->nodes[i - 1].obj);
-            }
-            curr = curr->prev;
-        }
+     * @return Bytes reserved after every allocation, a constant 0 unless `ARENA_DEBUG` is enabled.
+     */
+    [[nodiscard]] size_t redzone_size() const noexcept {
+#if ARENA_DEBUG
+        return debug_redzone;
+#else
+        return 0;
+#endif
+    }
 
-        destructor_block_latest = nullptr;
+    /**
+     * @brief Debug step of every bump allocation: unpoisons the padding and bytes handed out and places the redzone.
+     */
+    void debug_allocation([[maybe_unused]] char* ptr, [[maybe_unused]] const size_t size,
+                          [[maybe_unused]] const size_t padding) {
+#if ARENA_DEBUG
+        ARENA_UNPOISON(ptr - padding, padding + size);
+        place_redzone(ptr + size);
+#endif
+    }
 
-        for (MemBlock& mb : mem_blocks) {
-            mb.offset = 0;
+    /**
+     * @brief Releases blocks from index `first` onwards, newest first, while the arena exceeds `keep_bytes`.
+     *
+     * Blocks from `first` onwards must be empty.
+     *
+     * @return Bytes released.
+     */
+    size_t release_blocks_from(const size_t first, const size_t keep_bytes) noexcept {
+        size_t released = 0;
+        while (mem_blocks.size() > first && arena_size > keep_bytes) {
+            released += mem_blocks.back().size;
+            arena_size -= mem_blocks.back().size;
+            mem_blocks.pop_back();
         }
-
-        mem_block_latest_idx = 0;
+        return released;
     }
 
     /**
-     * @brief Allocates raw memory with user-specified alignment.
-     *
-     * This function is primarily used to work with STL allocator requirements.
+     * @brief Hands a block of at least `size` bytes to a child arena, see `ParentBlockSource`.
      *
-     * @param size Number of bytes to allocate.
-     * @param align Required alignment.
+     * Takes the first retained block that fits out of the block list, blocks past the latest one are empty,
+     * so no live allocation moves. Otherwise a new block is obtained from this arena's source.
      *
-     * @return Pointer to an aligned memory region within the arena.
+     * @return The block, with `size` set to its actual size, or nullptr if the source is exhausted.
      */
-    void* allocate_raw(const size_t size, const size_t align) noexcept {
-        return allocate(size, align);
+    void* lend_block(size_t& size) noexcept {
+        for (size_t idx = mem_block_latest_idx + 1; idx < mem_blocks.size(); ++idx) {
+            MemBlock& mb = mem_blocks[idx];
+            if (mb.source != source || mb.offset != 0 || mb.size < size) continue;
+
+            void* buffer = mb.buffer;
+            size = mb.size;
+            arena_size -= size;
+            mb.buffer = nullptr;
+            ARENA_UNPOISON(buffer, size);
+            mem_blocks.erase(mem_blocks.begin() + static_cast<ptrdiff_t>(idx));
+            return buffer;
+        }
+        return source->allocate(size);
     }
 
-
-    /** @return Total bytes of all allocated memory blocks. */
-    [[nodiscard]] size_t get_arena_size() const {return arena_size;}
-
-    /** @return Default bytes of a newly created memory block. */
-    [[nodiscard]] size_t get_single_block_size() const {return block_size;}
-
-    /** @return Number of memory blocks allocated so far. */
-    [[nodiscard]] size_t get_number_of_allocated_blocks() const {return mem_blocks.size();}
-
-private:
     /**
-     * @brief Destroys objects of type T.
-     *
-     * Pointers are stored as `void*` internally, so this re-casts and calls the destructor manually.
-     * Primary purpose of this template is to allow for compile-time dispatch, reducing the need to maintain vtable.
+     * @brief Takes back a block released by a child arena as a retained block of this arena.
      */
-    template<typename T>
-    static void destruct(void* p) noexcept {
-        static_cast<T*>(p)->~T();
+    void reclaim_block(void* buffer, const size_t size) noexcept {
+        mem_blocks.emplace_back(static_cast<char*>(buffer), size, source);
+        arena_size += size;
+        if (mem_blocks.size() == 1) load_latest_block();
     }
 
     /**
-     * @brief Node storing a destructor function and the associated object.
+     * @return A future that is already satisfied, for `clear_async()` calls that cleared synchronously.
      */
-    struct DestructorNode {
-        void (*fn)(void*);
-        void* obj;
-    };
+    static std::future<void> ready_future() {
+        std::promise<void> done;
+        done.set_value();
+        return done.get_future();
+    }
 
     /**
-    * @brief Chunk of destructor records, maintained as a linked list.
-    *
-    * Chunks are allocated inside the arena and chained backwards.
-    * Deallocation is also conducted backwards to align to lifetime semantics.
-    */
-    struct DestructorChunk {
-        DestructorNode nodes[DESTRUCTOR_CHUNK_SIZE]{};
-        size_t n_nodes = 0;
-        DestructorChunk* prev{};
-    };
+     * @return Whether every block used since the last clear may be released from another thread,
+     * false for a borrowed first block.
+     */
+    [[nodiscard]] bool used_blocks_thread_agnostic() const noexcept {
+        for (size_t idx = 0; idx <= mem_block_latest_idx; ++idx) {
+            const BlockSource* block_source = mem_blocks[idx].source;
+            if (!block_source || !block_source->thread_agnostic) return false;
+        }
+        return true;
+    }
 
     /**
-     * @brief Represents one contiguous memory block owned by the arena.
+     * @brief Retention step of `clear()`: ends an idle window every `retention.idle_clears` clears,
+     * releasing the blocks no cycle of the window entered.
      */
-    struct MemBlock {
-        char* buffer;
-        size_t size;
-        size_t offset;
+    void release_idle_blocks() noexcept {
+        idle_window_blocks = std::max(idle_window_blocks, mem_block_latest_idx + 1);
+        if (++idle_clears < retention.idle_clears) return;
 
-        explicit MemBlock(const size_t size): buffer(static_cast<char*>(::operator new(size))), size(size), offset(0) {}
+        release_blocks_from(idle_window_blocks, retention.keep_bytes);
+        idle_clears = 0;
+        idle_window_blocks = 0;
+    }
 
-        ~MemBlock() {
-            ::operator delete(buffer);
-        }
+#if ARENA_STATS
+    /**
+     * Accumulated counters, `bytes_in_use` and `bytes_reserved` are filled in by `get_stats()`.
+     */
+    ArenaStats stats;
+#endif
 
-        MemBlock(MemBlock&& other) noexcept : buffer(other.buffer), size(other.size), offset(other.offset) {
-            other.buffer = nullptr;
-            other.size = 0;
-            other.offset = 0;
-        }
+    /**
+     * @return Offset of the bump pointer within the latest block.
+     */
+    [[nodiscard]] size_t latest_offset() const noexcept {
+        return mem_blocks.empty() ? 0 : static_cast<size_t>(block_cursor - mem_blocks[mem_block_latest_idx].buffer);
+    }
 
-        MemBlock& operator=(MemBlock&& other) noexcept {
-            if (this != &other) {
-                ::operator delete(buffer);
-                buffer = other.buffer;
-                size = other.size;
-                offset = other.offset;
-                other.buffer = nullptr;
-                other.size = 0;
-                other.offset = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    /**
+     * @brief Writes `size` bytes to `fd`, retrying short and interrupted writes.
+     */
+    static bool write_all(const int fd, const void* data, size_t size) noexcept {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            const ssize_t written = ::write(fd, bytes, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
             }
-            return *this;
+            bytes += written;
+            size -= static_cast<size_t>(written);
         }
+        return true;
+    }
+#endif
 
-        MemBlock(const MemBlock&) = delete;
-        MemBlock& operator=(const MemBlock&) = delete;
-    };
+    /**
+     * @brief Writes the bump pointer back into the latest block's record.
+     */
+    void sync_latest_offset() noexcept {
+        if (!mem_blocks.empty()) mem_blocks[mem_block_latest_idx].offset = latest_offset();
+    }
 
     /**
-     * Tracks the location to add the latest destructor block as well as to remove destructor blocks.
+     * @brief Points the bump pointer at the latest block's record.
      */
-    DestructorChunk* destructor_block_latest = nullptr;
+    void load_latest_block() noexcept {
+        if (mem_blocks.empty()) {
+            block_cursor = nullptr;
+            block_end = nullptr;
+            return;
+        }
+        MemBlock& mb = mem_blocks[mem_block_latest_idx];
+        block_cursor = mb.buffer + mb.offset;
+        block_end = mb.buffer + mb.size;
+    }
 
     /**
-     * Tracks memory blocks
+     * @return Bytes currently allocated, summed over blocks. Blocks past the latest one are always empty.
      */
-    std::vector<MemBlock> mem_blocks;
+    [[nodiscard]] size_t bytes_in_use() const noexcept {
+        size_t in_use = 0;
+        for (size_t idx = 0; idx < mem_block_latest_idx; ++idx) {
+            in_use += mem_blocks[idx].offset;
+        }
+        return in_use + latest_offset();
+    }
 
     /**
-     * Tracks index of the latest memory block.
-     * Pointers are not used to avoid dangling references if vector resizes.
+     * @brief Folds current usage into the peak, called before anything lowers a block offset.
+     *
+     * Usage only grows in between, so sampling here (and in `get_stats()`) observes every peak.
      */
-    size_t mem_block_latest_idx;
+    void record_peak() noexcept {
+#if ARENA_STATS
+        stats.peak_bytes_in_use = std::max(stats.peak_bytes_in_use, bytes_in_use());
+#endif
+    }
 
     /**
-     * Minimal size of new memory blocks added.
+     * @brief Reports an allocation of `size` bytes of `T` to `ArenaProfiler`, compiled away without `ARENA_PROFILE`.
      */
-    size_t block_size;
+    template<typename T>
+    static void profile_allocation([[maybe_unused]] const size_t size,
+                                   [[maybe_unused]] const std::source_location& location = std::source_location{}) noexcept {
+#if ARENA_PROFILE
+        ArenaProfiler::record(size, alignof(T), arena_type_name<T>(), location);
+#endif
+    }
 
     /**
-     * Current size of the arena.
+     * @brief Reports an untyped allocation to `ArenaProfiler`, compiled away without `ARENA_PROFILE`.
      */
-    size_t arena_size;
+    static void profile_raw_allocation([[maybe_unused]] const size_t size, [[maybe_unused]] const size_t align) noexcept {
+#if ARENA_PROFILE
+        ArenaProfiler::record(size, align, {}, std::source_location{});
+#endif
+    }
+
+    /**
+     * @brief Counts a bump allocation of `size` bytes preceded by `padding` bytes of alignment.
+     */
+    void count_allocation([[maybe_unused]] const size_t size, [[maybe_unused]] const size_t padding) noexcept {
+#if ARENA_STATS
+        stats.n_allocations++;
+        stats.bytes_requested += size;
+        stats.padding_bytes += padding;
+#endif
+    }
 
     /**
      * @brief Allocates a new block.
@@ -273,44 +2021,45 @@ private:
      * Updates current arena size and sets new memory block as the latest memory block to allocate from.
      */
     inline void add_mem_block(const size_t size) noexcept {
-        mem_blocks.emplace_back(size);
+        sync_latest_offset();
+        mem_blocks.emplace_back(size, source);
         mem_block_latest_idx = mem_blocks.size() - 1;
-        arena_size += size;
+        arena_size += mem_blocks.back().size;
+        load_latest_block();
     };
 
     /**
      * @brief Allocation routine for the bump-pointer allocator.
      *
-     * Attempts to allocate within the current block.
-     * If current block is full, we create a new memory block.
+     * Aligns the cached bump pointer up and bounds-checks the result in a single branch.
+     * `allocate` is inlined into every caller, so a compile-time `align` (as in `create<T>`) folds the
+     * alignment into constants, and `align == 1` drops it entirely.
+     * If current block is full, we move on to another memory block.
      *
      * @return Pointer to the allocated memory.
      */
     inline void* allocate(const size_t size, const size_t align) noexcept {
-        MemBlock& mb = mem_blocks[mem_block_latest_idx];
+        // manual alignment logic
+        // 1. `align` is always a power of two.
+        //      align = 16 → binary 00010000
+        //
+        // 2. `align - 1` produces a mask of the lower bits.
+        //       align - 1 = 15 → binary 00001111
+        //
+        // 3. Negating the address and masking with `align - 1` gives the distance to the next multiple of `align`:
+        //       cursor = 0x1013
+        //       -cursor & 0x0F = 0x0D
+        //       0x1013 + 0x0D = 0x1020  (aligned address)
+        //
+        // 4. `block_end - block_cursor` is never negative, so padding and size are checked against it at once.
 
-        // cheap allocation if alignment matches
-        if (const size_t potential_offset = mb.offset + size; potential_offset <= mb.size) [[likely]] {
-
-            // manual alignment check
-            // 1. `align` is always a power of two.
-            //      align = 16 → binary 00010000
-            //
-            // 2. `align - 1` produces a mask of the lower bits.
-            //       align - 1 = 15 → binary 00001111
-            //
-            // 3. For any aligned address `A`, the lower bits must be zero:
-            //       A % 16 == 0
-            //       A & 0x0F == 0
-
-            if (void *const ptr = mb.buffer + mb.offset; (reinterpret_cast<uintptr_t>(ptr) & (align - 1)) == 0) [[likely
-            ]] {
-                mb.offset = potential_offset;
-                return ptr;
-            }
-        }
+        const size_t padding = (0 - reinterpret_cast<uintptr_t>(block_cursor)) & (align - 1);
 
-        if (void *ptr = allocate_from_mem_block(mb, size, align)) [[likely]] {
+        if (padding + size + redzone_size() <= static_cast<size_t>(block_end - block_cursor)) [[likely]] {
+            char* const ptr = block_cursor + padding;
+            block_cursor += padding + size + redzone_size();
+            count_allocation(size, padding);
+            debug_allocation(ptr, size, padding);
             return ptr;
         }
 
@@ -319,7 +2068,37 @@ private:
     }
 
     /**
-    * @brief Allocates a larger block if needed and retries allocation.
+     * @brief `allocate` with a compile-time alignment.
+     *
+     * The padding is computed from constants, and skipped entirely for `Align == 1`,
+     * so the fast path is one subtraction and one compare.
+     */
+    template<size_t Align>
+    inline void* allocate_aligned(const size_t size) noexcept {
+        static_assert(Align != 0 && (Align & (Align - 1)) == 0, "alignment must be a power of two");
+
+        size_t padding = 0;
+        if constexpr (Align > 1) {
+            padding = (0 - reinterpret_cast<uintptr_t>(block_cursor)) & (Align - 1);
+        }
+
+        if (padding + size + redzone_size() <= static_cast<size_t>(block_end - block_cursor)) [[likely]] {
+            char* const ptr = block_cursor + padding;
+            block_cursor += padding + size + redzone_size();
+            count_allocation(size, padding);
+            debug_allocation(ptr, size, padding);
+            return ptr;
+        }
+
+        return add_new_block_and_allocate(size, Align);
+    }
+
+    /**
+    * @brief Moves on to the next retained block, or allocates a larger block if needed, and retries allocation.
+    *
+    * Blocks retained across `clear()` are reused in order before asking the system for more memory,
+    * so an arena that is repeatedly filled and cleared stops growing once it has warmed up.
+    * Retained blocks too small for the request are skipped for the remainder of the cycle.
     *
     * We assume most allocation to the latest `MemBlock` will succeed.
     * Hence, this function should not be called often and is marked as non-inline for better code layout.
@@ -328,10 +2107,54 @@ private:
     */
     __attribute__((noinline))
     void* add_new_block_and_allocate(const size_t size, const size_t align) noexcept {
-        const size_t new_block_size = std::max(size + align - 1, block_size);
+#if ARENA_STATS
+        stats.n_slow_path++;
+#endif
+        sync_latest_offset();
+        if (void* p = extend_latest_block_and_allocate(size, align)) return p;
+
+#if ARENA_STATS
+        stats.tail_waste_bytes += static_cast<size_t>(block_end - block_cursor);
+#endif
+        for (size_t idx = mem_block_latest_idx + 1; idx < mem_blocks.size(); ++idx) {
+            if (void* p = allocate_from_mem_block(mem_blocks[idx], size, align)) {
+                mem_block_latest_idx = idx;
+                load_latest_block();
+                return p;
+            }
+        }
+
+        next_block_size = growth.next(next_block_size);
+        const size_t new_block_size = std::max(size + align - 1 + redzone_size(), next_block_size);
         add_mem_block(new_block_size);
 
         void* p = allocate_from_mem_block(mem_blocks[mem_block_latest_idx], size, align);
+        load_latest_block();
+        return p;
+    }
+
+    /**
+     * @brief Grows the latest block in place by the next block size, if its source supports `extend_fn`.
+     *
+     * @return Pointer to the allocated memory, or nullptr if the block could not be grown enough.
+     */
+    void* extend_latest_block_and_allocate(const size_t size, const size_t align) noexcept {
+        if (mem_blocks.empty()) return nullptr;
+
+        MemBlock& mb = mem_blocks[mem_block_latest_idx];
+        if (!mb.source || !mb.source->extend_fn) return nullptr;
+
+        const size_t step = growth.next(next_block_size);
+        size_t new_size = std::max(mb.size + step, mb.offset + size + align - 1 + redzone_size());
+        if (!mb.source->extend(mb.buffer, mb.size, new_size) || new_size <= mb.size) return nullptr;
+
+        ARENA_POISON(mb.buffer + mb.size, new_size - mb.size);
+        next_block_size = step;
+        arena_size += new_size - mb.size;
+        mb.size = new_size;
+
+        void* p = allocate_from_mem_block(mb, size, align);
+        load_latest_block();
         return p;
     }
 
@@ -342,7 +2165,7 @@ private:
      *
      * @return Pointer to aligned memory, or nullptr if the block overflows.
      */
-    static inline void* allocate_from_mem_block(MemBlock& mem_block, const size_t size, const size_t align) noexcept {
+    inline void* allocate_from_mem_block(MemBlock& mem_block, const size_t size, const size_t align) noexcept {
         const uintptr_t curr = reinterpret_cast<uintptr_t>(mem_block.buffer + mem_block.offset);
 
         // manual alignment logic
@@ -366,11 +2189,13 @@ private:
 
         const uintptr_t aligned = (curr + align - 1) & ~(align - 1);
         const size_t padding = aligned - curr;
-        const size_t new_offset = mem_block.offset + padding + size;
+        const size_t new_offset = mem_block.offset + padding + size + redzone_size();
 
         if (new_offset > mem_block.size) [[unlikely]] return nullptr;
 
         mem_block.offset = new_offset;
+        count_allocation(size, padding);
+        debug_allocation(reinterpret_cast<char*>(aligned), size, padding);
         return reinterpret_cast<void*>(aligned);
     }
 
@@ -378,14 +2203,35 @@ private:
      * @brief Registers a destructor a new object.
      *
      * Destructors are stored in a linked list of chunks. A new chunk is created if the current chunk if full.
+     * If `obj` directly follows the latest run of the same type, the run is extended instead,
+     * which keeps the reverse destruction order since `destruct_n` tears a run down last to first.
      *
-     * @param obj Pointer to the object.
-     * @param fn Pointer to the destructor function.
+     * @tparam T Type of the objects.
+     * @param obj Pointer to the object, or the first element of an array.
+     * @param count Number of objects starting at `obj`.
      */
-    inline void append_new_destructor(void* obj, void (*fn)(void*)) noexcept {
+    template<typename T>
+    inline void append_new_destructor(T* obj, const size_t count) noexcept {
+        if (leak_destructors) [[unlikely]] return;
+
+#if ARENA_STATS
+        stats.n_destructor_registrations++;
+#endif
+
+        if (destructor_block_latest && destructor_block_latest->n_nodes) [[likely]] {
+            DestructorNode& run = destructor_block_latest->nodes[destructor_block_latest->n_nodes - 1];
+            if (run.fn == &destruct_n<T> && static_cast<T*>(run.obj) + run.count == obj) {
+                run.count += count;
+                return;
+            }
+        }
+
         if (!destructor_block_latest || destructor_block_latest->n_nodes == DESTRUCTOR_CHUNK_SIZE) [[unlikely]] {
-            void* ptr = allocate(sizeof(DestructorChunk), alignof(DestructorChunk));
+            void* ptr = allocate_aligned<alignof(DestructorChunk)>(sizeof(DestructorChunk));
             DestructorChunk* dest_mb = new (ptr) DestructorChunk();
+#if ARENA_STATS
+            stats.destructor_chunk_bytes += sizeof(DestructorChunk);
+#endif
             dest_mb->n_nodes = 0;
             dest_mb->prev = destructor_block_latest;
 
@@ -393,9 +2239,241 @@ private:
         }
 
         DestructorNode& node = destructor_block_latest->nodes[destructor_block_latest->n_nodes++];
-        node.fn = fn;
+        node.fn = &destruct_n<T>;
         node.obj = obj;
+        node.count = count;
+        node.stride = sizeof(T);
+    }
+
+    /**
+     * @brief Allocates uninitialised storage for `n` objects of type T.
+     */
+    template<typename T>
+    T* allocate_array(const size_t n) {
+        if (n == 0) return nullptr;
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        profile_allocation<T>(n * sizeof(T));
+        return static_cast<T*>(allocate_aligned<alignof(T)>(n * sizeof(T)));
+    }
+
+protected:
+    /**
+     * Bytes of inline storage needed per block record of an `InlineArenaV2`.
+     */
+    static constexpr size_t MEM_BLOCK_RECORD_SIZE = sizeof(MemBlock);
+
+    /**
+     * @brief Constructs an arena whose first block and first block records live in caller-provided storage.
+     *
+     * Used by `InlineArenaV2`, spilled blocks are obtained from `options.source` as usual.
+     *
+     * @param inline_buffer First block, borrowed for the life of the arena.
+     * @param inline_size Size (in bytes) of `inline_buffer`.
+     * @param inline_slots Storage for `n_inline_slots` block records.
+     * @param n_inline_slots Number of block records `inline_slots` holds.
+     * @param options `block_size` sizes the first spilled block.
+     */
+    ArenaV2(char* inline_buffer, const size_t inline_size, void* inline_slots, const size_t n_inline_slots,
+            const ArenaOptions& options) :
+        mem_blocks(BlockListAllocator<MemBlock>(inline_slots, n_inline_slots)),
+        mem_block_latest_idx(0),
+        block_size(options.block_size),
+        next_block_size(options.block_size),
+        growth(options.growth),
+        source(options.source),
+        arena_size(inline_size),
+        leak_destructors(options.leak_destructors),
+        adaptive(options.adaptive),
+        retention(options.retention)
+#if ARENA_DEBUG
+        , debug_redzone(options.debug_redzone)
+#endif
+    {
+        mem_blocks.reserve(n_inline_slots);
+        mem_blocks.emplace_back(inline_buffer, inline_size);
+        load_latest_block();
+    }
+
+    /**
+     * @brief Destroys every object and releases every block, leaving the arena empty.
+     */
+    void release_all() noexcept {
+        destroy_objects();
+        mem_blocks.clear();
+        mem_block_latest_idx = 0;
+        load_latest_block();
+        arena_size = 0;
+    }
+};
+
+/**
+ * @class ParentBlockSource
+ * @brief Block source borrowing blocks from a parent arena instead of the system.
+ *
+ * Blocks are taken from the parent's retained blocks when one is large enough, otherwise from the parent's source,
+ * and are handed back to the parent as retained blocks when released. Nested lifetimes thus recycle the memory
+ * of the outermost arena rather than each paying for their own blocks, and a parent cleared while a child is alive
+ * keeps none of the child's blocks.
+ *
+ * @code
+ * ArenaV2 query(1 << 20);
+ * ParentBlockSource source(query);
+ * ArenaV2 batch(ArenaOptions{.block_size = 64 * 1024, .source = &source});
+ * @endcode
+ *
+ * @warning The parent must outlive every arena using it, and be used from the same thread.
+ */
+class ParentBlockSource : public BlockSource {
+public:
+    explicit ParentBlockSource(ArenaV2& parent) noexcept :
+        BlockSource{.allocate_fn = &parent_allocate, .deallocate_fn = &parent_deallocate, .thread_agnostic = false},
+        parent(&parent) {}
+
+    [[nodiscard]] ArenaV2& get_parent() const noexcept {return *parent;}
+
+private:
+    ArenaV2* parent;
+
+    static void* parent_allocate(BlockSource* self, size_t& size) noexcept {
+        return static_cast<ParentBlockSource*>(self)->parent->lend_block(size);
+    }
+
+    static void parent_deallocate(BlockSource* self, void* ptr, const size_t size) noexcept {
+        static_cast<ParentBlockSource*>(self)->parent->reclaim_block(ptr, size);
+    }
+};
+
+/**
+ * @brief Holds the source of a `ChildArenaV2`, a base class so that it is constructed before the arena.
+ */
+struct ChildArenaSource {
+    ParentBlockSource parent_source;
+};
+
+/**
+ * @class ChildArenaV2
+ * @brief An `ArenaV2` nested in the lifetime of a parent arena, created by `ArenaV2::make_child()`.
+ *
+ * Blocks come from the parent through a `ParentBlockSource`, so children are cheap to create per batch
+ * once the parent has warmed up, and total memory stays bounded by the outermost arena.
+ * On every `clear()` the blocks the finished cycle did not enter go back to the parent,
+ * and destroying the child returns the rest. Children can have children of their own.
+ *
+ * @code
+ * ArenaV2 query(1 << 20);
+ * for (const Batch& batch : batches) {
+ *     ChildArenaV2 scratch = query.make_child(64 * 1024);
+ *     process(batch, scratch);
+ * }
+ * @endcode
+ *
+ * @warning Not movable, the arena points at its own source. Must be destroyed before its parent.
+ */
+class ChildArenaV2 : private ChildArenaSource, public ArenaV2 {
+public:
+    ChildArenaV2(ArenaV2& parent, const size_t size) :
+        ChildArenaSource{ParentBlockSource(parent)},
+        ArenaV2(ArenaOptions{
+            .block_size = size,
+            .source = &parent_source,
+            .retention = {.idle_clears = 1},
+        }) {}
+
+    ChildArenaV2(const ChildArenaV2&) = delete;
+    ChildArenaV2& operator=(const ChildArenaV2&) = delete;
+    ChildArenaV2(ChildArenaV2&&) = delete;
+    ChildArenaV2& operator=(ChildArenaV2&&) = delete;
+
+    [[nodiscard]] ArenaV2& get_parent() const noexcept {return parent_source.get_parent();}
+};
+
+inline ChildArenaV2 ArenaV2::make_child() {
+    return make_child(block_size);
+}
+
+inline ChildArenaV2 ArenaV2::make_child(const size_t size) {
+    return ChildArenaV2(*this, size);
+}
+
+/**
+ * @class InlineArenaV2
+ * @brief An `ArenaV2` whose first `N` bytes live inside the object, so small arenas can sit on the stack.
+ *
+ * The first block and the first few block records are embedded inline, constructing an `InlineArenaV2`
+ * makes no heap allocation. It spills to heap blocks (sized by `options.block_size` and the growth policy)
+ * only once the inline block is exhausted, and exposes the full `ArenaV2` interface, including `ArenaAllocator`.
+ *
+ * @code
+ * InlineArenaV2<512> arena;
+ * std::vector<int, ArenaAllocator<int>> vec{ArenaAllocator<int>(arena)};
+ * @endcode
+ *
+ * @tparam N Bytes of inline storage.
+ * @tparam NBlockSlots Number of block records stored inline before the block list moves to the heap.
+ *
+ * @warning Not movable, not even through an `ArenaV2&`, the inline storage cannot follow a move.
+ */
+template<size_t N, size_t NBlockSlots = INLINE_ARENA_BLOCK_SLOTS>
+class InlineArenaV2 : public ArenaV2 {
+public:
+    explicit InlineArenaV2(const ArenaOptions& options = {}) :
+        ArenaV2(inline_buffer, N, block_slots, NBlockSlots, options) {}
+
+    /**
+     * @brief Destroys every object while the inline storage is still alive.
+     */
+    ~InlineArenaV2() {
+        release_all();
+    }
+
+    InlineArenaV2(const InlineArenaV2&) = delete;
+    InlineArenaV2& operator=(const InlineArenaV2&) = delete;
+    InlineArenaV2(InlineArenaV2&&) = delete;
+    InlineArenaV2& operator=(InlineArenaV2&&) = delete;
+
+private:
+    alignas(std::max_align_t) char inline_buffer[N];
+    alignas(std::max_align_t) unsigned char block_slots[NBlockSlots * MEM_BLOCK_RECORD_SIZE];
+};
+
+/**
+ * @brief Alias emphasising stack residency.
+ */
+template<size_t N>
+using StackArena = InlineArenaV2<N>;
+
+/**
+ * @class ScopedArenaFrame
+ * @brief RAII scratch frame: rewinds the arena to its position at construction when the frame goes out of scope.
+ *
+ * Frames nest like a stack, an inner frame must be destroyed before an outer one.
+ *
+ * @code
+ * ArenaV2 arena;
+ * {
+ *     ScopedArenaFrame frame(arena);
+ *     auto* tmp = arena.create<Node>();  // destroyed and reclaimed at the end of the scope
+ * }
+ * @endcode
+ */
+class ScopedArenaFrame {
+public:
+    explicit ScopedArenaFrame(ArenaV2& arena) noexcept : arena(arena), marker(arena.mark()) {}
+
+    ~ScopedArenaFrame() {
+        arena.rewind(marker);
     }
+
+    ScopedArenaFrame(const ScopedArenaFrame&) = delete;
+    ScopedArenaFrame& operator=(const ScopedArenaFrame&) = delete;
+    ScopedArenaFrame(ScopedArenaFrame&&) = delete;
+    ScopedArenaFrame& operator=(ScopedArenaFrame&&) = delete;
+
+private:
+    ArenaV2& arena;
+    ArenaV2::Marker marker;
 };
 
 /**
@@ -403,10 +2481,12 @@ private:
  * @brief STL-compatible allocator using an ArenaV2 for fast monotonic allocation.
  *
  * ArenaAllocator provides an adapter that allows STL containers to allocate memory directly from an `ArenaV2` instance.
+ * Any arena exposing `allocate_raw(size, align)` (e.g. `ConcurrentArena`) may be used in place of `ArenaV2`.
  *
  * @tparam T Value type the allocator handles.
+ * @tparam Arena Arena type memory is drawn from.
  */
-template<typename T>
+template<typename T, typename Arena = ArenaV2>
 class ArenaAllocator {
 public:
     using value_type = T;
@@ -423,19 +2503,19 @@ public:
      */
     using is_always_equal = std::false_type;
 
-    ArenaV2* arena;
+    Arena* arena;
 
-    template<typename U>
+    template<typename U, typename A>
     friend class ArenaAllocator;
 
     ArenaAllocator() = delete;
 
     /**
-     * @brief Constructs an allocator bound to a specific ArenaV2.
+     * @brief Constructs an allocator bound to a specific arena.
      *
      * @param arena The arena from which memory will be allocated.
      */
-    explicit ArenaAllocator(ArenaV2& arena) noexcept : arena(&arena) {};
+    explicit ArenaAllocator(Arena& arena) noexcept : arena(&arena) {};
 
     /**
      * @brief Copy constructor.
@@ -450,7 +2530,7 @@ public:
      * @param other Allocator to convert from.
      */
     template<typename U>
-    explicit ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {};
+    explicit ArenaAllocator(const ArenaAllocator<U, Arena>& other) noexcept : arena(other.arena) {};
 
     /**
      * @brief Allocates memory for `n` objects of type `T` from the arena.
@@ -464,32 +2544,42 @@ public:
      */
     T* allocate(const size_type n) {
         if (n == 0) return nullptr;
-        if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
-            throw std::bad_array_new_length();
+        if constexpr (requires { arena->template allocate<T>(n); }) {
+            return arena->template allocate<T>(n);
+        } else {
+            if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            return static_cast<T*>(arena->allocate_raw(n * sizeof(T), alignof(T)));
         }
-        return static_cast<T*>(arena->allocate_raw(n * sizeof(T), alignof(T)));
     }
 
     /**
-     * @brief No-op.
+     * @brief Returns the memory to arenas that recycle individual frees (e.g. `PoolArena`), no-op for `ArenaV2`.
      *
      * STL containers may call `deallocate(ptr, n)` during resizing.
      * `ArenaV2` is monotonic and assumes all allocated objects have the same lifetime.
-     * Hence, individual frees should not return memory to the arena.
+     * Hence, individual frees do not return memory to it, not even the most recent allocation:
+     * a container freeing a buffer from before a `clear()` could match the bump pointer of the new cycle
+     * and roll it back over live objects. Explicit rollback is left to `ArenaV2::deallocate_raw`.
      *
      * @param ptr Pointer to memory previously returned by allocate().
      * @param n   Number of T elements originally allocated.
      */
-    void deallocate(const T* ptr, const size_type n) noexcept {
-        (void) ptr;
-        (void) n;
+    void deallocate(T* ptr, const size_type n) noexcept {
+        if constexpr (!std::is_base_of_v<ArenaV2, Arena> && requires { arena->deallocate_raw(ptr, n * sizeof(T)); }) {
+            if (ptr) arena->deallocate_raw(ptr, n * sizeof(T));
+        } else {
+            (void) ptr;
+            (void) n;
+        }
     }
 
     /**
      * @brief Allocators are equal if they use the same arena.
      */
     template<typename U>
-    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+    bool operator==(const ArenaAllocator<U, Arena>& other) const noexcept {
         return arena == other.arena;
     }
 
@@ -497,7 +2587,7 @@ public:
      * @brief Check if non-equal.
      */
     template<typename U>
-    bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+    bool operator!=(const ArenaAllocator<U, Arena>& other) const noexcept {
         return !(*this == other);
     }
 };
@@ -0,0 +1,125 @@
+#ifndef ARENA_COROUTINE_H
+#define ARENA_COROUTINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include "arena.h"
+
+/**
+ * Bytes reserved in front of every coroutine frame to record where (and in which arena epoch) it was allocated,
+ * a multiple of the default `operator new` alignment so the frame itself stays aligned.
+ */
+inline constexpr size_t ARENA_COROUTINE_FRAME_HEADER =
+    (sizeof(void*) + sizeof(uint64_t) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+/**
+ * @class ArenaCoroutinePromise
+ * @brief Base of a coroutine promise type whose frames are allocated from an `ArenaV2`.
+ *
+ * Deriving the promise type from `ArenaCoroutinePromise` replaces its `operator new` and `operator delete`.
+ * The frame is taken from, in order:
+ *  1. the arena passed as the coroutine's first parameter (the second one for member coroutines),
+ *     following the leading-allocator convention. The promise cannot tell a member coroutine's object
+ *     from an ordinary parameter, so a free coroutine whose first parameter is a class object
+ *     and second an `ArenaV2&`, e.g. `Task f(Config&, ArenaV2&)`, takes its frame from that arena as well,
+ *  2. the calling thread's current arena, installed with `ArenaCoroutineScope`,
+ *  3. the global `::operator new`.
+ *
+ * Frames are not registered with the arena's destructor list, destroying the coroutine frees its frame,
+ * and a frame that is still the arena's most recent allocation of the epoch it was allocated in is reclaimed
+ * immediately (`deallocate_raw`), so short-lived tasks spawned and finished in a stack-like order keep reusing
+ * the same bytes.
+ *
+ * @code
+ * struct Task {
+ *     struct promise_type : ArenaCoroutinePromise { ... };
+ * };
+ *
+ * Task parse(ArenaV2& arena, std::string_view input);  // frame from `arena`
+ *
+ * ArenaCoroutineScope scope(arena);
+ * Task task = run();                       // frame from the current arena
+ * @endcode
+ *
+ * @warning Every frame allocated from an arena must be destroyed before the arena is cleared or destroyed.
+ */
+class ArenaCoroutinePromise {
+public:
+    static void* operator new(const size_t size) {
+        return allocate_frame(current_arena, size);
+    }
+
+    template<typename... Args>
+    static void* operator new(const size_t size, ArenaV2& arena, Args&...) {
+        return allocate_frame(&arena, size);
+    }
+
+    template<typename This, typename... Args>
+        requires (std::is_class_v<std::remove_cvref_t<This>> && !std::is_base_of_v<ArenaV2, std::remove_cvref_t<This>>)
+    static void* operator new(const size_t size, This&, ArenaV2& arena, Args&...) {
+        return allocate_frame(&arena, size);
+    }
+
+    static void operator delete(void* ptr, const size_t size) noexcept {
+        char* base = static_cast<char*>(ptr) - ARENA_COROUTINE_FRAME_HEADER;
+        const auto* header = reinterpret_cast<const FrameHeader*>(base);
+
+        if (!header->arena) {
+            ::operator delete(base);
+            return;
+        }
+        header->arena->deallocate_raw(base, size + ARENA_COROUTINE_FRAME_HEADER, header->epoch);
+    }
+
+    /** @return The calling thread's current arena, or nullptr if frames go to the heap. */
+    [[nodiscard]] static ArenaV2* get_current_arena() noexcept {return current_arena;}
+
+private:
+    friend class ArenaCoroutineScope;
+
+    struct FrameHeader {
+        ArenaV2* arena;
+        uint64_t epoch;
+    };
+    static_assert(sizeof(FrameHeader) <= ARENA_COROUTINE_FRAME_HEADER);
+
+    static inline thread_local ArenaV2* current_arena = nullptr;
+
+    static void* allocate_frame(ArenaV2* arena, const size_t size) {
+        const size_t total = size + ARENA_COROUTINE_FRAME_HEADER;
+        void* base = arena ? arena->allocate_raw(total, alignof(std::max_align_t)) : ::operator new(total);
+        if (!base) throw std::bad_alloc();
+
+        new (base) FrameHeader{arena, arena ? arena->get_epoch() : 0};
+        return static_cast<char*>(base) + ARENA_COROUTINE_FRAME_HEADER;
+    }
+};
+
+/**
+ * @class ArenaCoroutineScope
+ * @brief RAII installation of the calling thread's current coroutine arena, see `ArenaCoroutinePromise`.
+ *
+ * Scopes nest, the previous arena is restored on destruction.
+ */
+class ArenaCoroutineScope {
+public:
+    explicit ArenaCoroutineScope(ArenaV2& arena) noexcept : previous(ArenaCoroutinePromise::current_arena) {
+        ArenaCoroutinePromise::current_arena = &arena;
+    }
+
+    ~ArenaCoroutineScope() {
+        ArenaCoroutinePromise::current_arena = previous;
+    }
+
+    ArenaCoroutineScope(const ArenaCoroutineScope&) = delete;
+    ArenaCoroutineScope& operator=(const ArenaCoroutineScope&) = delete;
+    ArenaCoroutineScope(ArenaCoroutineScope&&) = delete;
+    ArenaCoroutineScope& operator=(ArenaCoroutineScope&&) = delete;
+
+private:
+    ArenaV2* previous;
+};
+
+#endif //ARENA_COROUTINE_H
@@ -0,0 +1,518 @@
+#ifndef ARENA_HASH_MAP_H
+#define ARENA_HASH_MAP_H
+
+#include <bit>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "arena.h"
+
+inline constexpr size_t ARENA_HASH_MAP_GROUP_WIDTH = 16;
+inline constexpr size_t ARENA_HASH_MAP_MIN_CAPACITY = ARENA_HASH_MAP_GROUP_WIDTH;
+
+/**
+ * @class ArenaHashMap
+ * @brief Flat open-addressing hash map allocated from an `ArenaV2`, probing SwissTable-style control bytes.
+ *
+ * Every slot has a control byte: empty, deleted, or the low 7 bits of the key's hash. A lookup hashes once,
+ * then compares 16 control bytes at a time (one SSE2 compare, or a portable byte loop elsewhere)
+ * and only touches slots whose byte matches, so a lookup is usually a single cache miss, with no node chasing.
+ *
+ * Slots and control bytes share one arena allocation. When the map is the arena's latest allocation it grows
+ * through `ArenaV2::try_extend` without leaving its old table behind, otherwise it moves into a fresh table
+ * and the old one stays dead in the arena until the next `clear()`. On destruction a table that is still
+ * the latest allocation of its epoch is handed back with `deallocate_raw`. The table is kept at most 7/8 full.
+ *
+ * @code
+ * ArenaV2 arena(1 << 20);
+ * ArenaHashMap<int, int> map(arena);
+ * map[42] = 1;
+ * @endcode
+ *
+ * @tparam K Key type, copied when the table grows.
+ * @tparam V Mapped type.
+ *
+ * @note Elements are destroyed with the map; memory is reclaimed by the arena.
+ * @warning Growing, erasing and rehashing invalidate iterators and references.
+ */
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class ArenaHashMap {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using size_type = size_t;
+
+    template<bool Const>
+    class Iterator {
+        friend class ArenaHashMap;
+        template<bool> friend class Iterator;
+        using slot_pointer = std::conditional_t<Const, const std::pair<const K, V>*, std::pair<const K, V>*>;
+
+        const int8_t* ctrl;
+        const int8_t* ctrl_end;
+        slot_pointer slot;
+
+        Iterator(const int8_t* ctrl, const int8_t* ctrl_end, const slot_pointer slot) noexcept :
+            ctrl(ctrl), ctrl_end(ctrl_end), slot(slot) {}
+
+        void skip_free() noexcept {
+            while (ctrl != ctrl_end && *ctrl < 0) {
+                ++ctrl;
+                ++slot;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<const K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = slot_pointer;
+
+        Iterator() noexcept : ctrl(nullptr), ctrl_end(nullptr), slot(nullptr) {}
+
+        operator Iterator<true>() const noexcept {return {ctrl, ctrl_end, slot};}
+
+        reference operator*() const noexcept {return *slot;}
+        pointer operator->() const noexcept {return slot;}
+
+        Iterator& operator++() noexcept {
+            ++ctrl;
+            ++slot;
+            skip_free();
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator prev = *this;
+            ++*this;
+            return prev;
+        }
+
+        bool operator==(const Iterator& other) const noexcept {return ctrl == other.ctrl;}
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * @param arena Arena holding the table.
+     * @param capacity Number of elements to reserve room for, no table is allocated if 0.
+     */
+    explicit ArenaHashMap(ArenaV2& arena, const size_t capacity = 0, const Hash& hash = Hash(),
+                          const KeyEqual& key_eq = KeyEqual()) :
+        arena(&arena), hasher(hash), key_eq(key_eq) {
+        reserve(capacity);
+    }
+
+    ~ArenaHashMap() {
+        release();
+    }
+
+    ArenaHashMap(const ArenaHashMap&) = delete;
+    ArenaHashMap& operator=(const ArenaHashMap&) = delete;
+
+    ArenaHashMap(ArenaHashMap&& other) noexcept :
+        arena(other.arena), hasher(std::move(other.hasher)), key_eq(std::move(other.key_eq)), table(other.table),
+        slots(other.slots), ctrl(other.ctrl), n_capacity(other.n_capacity), n_size(other.n_size),
+        growth_left(other.growth_left), epoch(other.epoch) {
+        other.forget();
+    }
+
+    ArenaHashMap& operator=(ArenaHashMap&& other) noexcept {
+        if (this != &other) {
+            release();
+            arena = other.arena;
+            hasher = std::move(other.hasher);
+            key_eq = std::move(other.key_eq);
+            table = other.table;
+            slots = other.slots;
+            ctrl = other.ctrl;
+            n_capacity = other.n_capacity;
+            n_size = other.n_size;
+            growth_left = other.growth_left;
+            epoch = other.epoch;
+            other.forget();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Inserts `key` with a value constructed from `args`, unless `key` is already present.
+     *
+     * @return Iterator to the element for `key`, and whether it was inserted.
+     */
+    template<typename ...Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&& ... args) {
+        const size_t hash = hash_of(key);
+        if (const size_t idx = find_index(key, hash); idx != NOT_FOUND) {
+            return {iterator_at(idx), false};
+        }
+
+        if (growth_left == 0) [[unlikely]] grow();
+
+        const size_t idx = find_first_non_full(hash);
+        new (slots + idx) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                     std::forward_as_tuple(std::forward<Args>(args)...));
+        if (ctrl[idx] == CTRL_EMPTY) growth_left--;
+        ctrl[idx] = h2(hash);
+        n_size++;
+        return {iterator_at(idx), true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    /**
+     * @return Value for `key`, value-initialised and inserted if absent.
+     */
+    V& operator[](const K& key) {
+        return try_emplace(key).first->second;
+    }
+
+    /**
+     * @return Value for `key`.
+     * @throws std::out_of_range if `key` is absent.
+     */
+    V& at(const K& key) {
+        const size_t idx = find_index(key, hash_of(key));
+        if (idx == NOT_FOUND) throw std::out_of_range("ArenaHashMap::at");
+        return slots[idx].second;
+    }
+
+    const V& at(const K& key) const {
+        return const_cast<ArenaHashMap*>(this)->at(key);
+    }
+
+    iterator find(const K& key) noexcept {
+        const size_t idx = find_index(key, hash_of(key));
+        return idx == NOT_FOUND ? end() : iterator_at(idx);
+    }
+
+    const_iterator find(const K& key) const noexcept {
+        return const_cast<ArenaHashMap*>(this)->find(key);
+    }
+
+    [[nodiscard]] bool contains(const K& key) const noexcept {
+        return find_index(key, hash_of(key)) != NOT_FOUND;
+    }
+
+    /**
+     * @brief Removes `key`, leaving a tombstone unless its group still has an empty slot.
+     *
+     * @return Number of elements removed, 0 or 1.
+     */
+    size_t erase(const K& key) noexcept {
+        const size_t idx = find_index(key, hash_of(key));
+        if (idx == NOT_FOUND) return 0;
+
+        slots[idx].~value_type();
+        n_size--;
+
+        // a group with an empty slot has never been full, so no probe sequence runs past it.
+        if (Group(ctrl + group_start(idx)).match_empty()) {
+            ctrl[idx] = CTRL_EMPTY;
+            growth_left++;
+        } else {
+            ctrl[idx] = CTRL_DELETED;
+        }
+        return 1;
+    }
+
+    /**
+     * @brief Destroys every element, the table is kept.
+     */
+    void clear() noexcept {
+        destroy_elements();
+        if (ctrl) std::memset(ctrl, static_cast<unsigned char>(CTRL_EMPTY), n_capacity);
+        n_size = 0;
+        growth_left = max_load(n_capacity);
+    }
+
+    /**
+     * @brief Ensures room for at least `n` elements without growing.
+     */
+    void reserve(const size_t n) {
+        if (n <= n_size + growth_left) return;
+
+        size_t capacity = std::max(n_capacity, ARENA_HASH_MAP_MIN_CAPACITY);
+        while (max_load(capacity) < n) capacity *= 2;
+        resize(capacity);
+    }
+
+    iterator begin() noexcept {
+        iterator it(ctrl, ctrl + n_capacity, slots);
+        it.skip_free();
+        return it;
+    }
+
+    iterator end() noexcept {return iterator(ctrl + n_capacity, ctrl + n_capacity, slots + n_capacity);}
+    const_iterator begin() const noexcept {return const_cast<ArenaHashMap*>(this)->begin();}
+    const_iterator end() const noexcept {return const_cast<ArenaHashMap*>(this)->end();}
+
+    [[nodiscard]] size_t size() const noexcept {return n_size;}
+    [[nodiscard]] bool empty() const noexcept {return n_size == 0;}
+
+    /** @return Number of slots of the table. */
+    [[nodiscard]] size_t capacity() const noexcept {return n_capacity;}
+
+private:
+    static constexpr int8_t CTRL_EMPTY = -128;
+    static constexpr int8_t CTRL_DELETED = -2;
+    static constexpr size_t NOT_FOUND = std::numeric_limits<size_t>::max();
+
+    /**
+     * @brief 16 control bytes matched at once, with SSE2 where available.
+     */
+    struct Group {
+#if defined(__SSE2__)
+        __m128i bytes;
+
+        explicit Group(const int8_t* pos) noexcept : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+        [[nodiscard]] uint32_t match(const int8_t h) const noexcept {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), bytes)));
+        }
+
+        // empty and deleted bytes are the only ones with the sign bit set.
+        [[nodiscard]] uint32_t match_non_full() const noexcept {
+            return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+        }
+#else
+        const int8_t* pos;
+
+        explicit Group(const int8_t* pos) noexcept : pos(pos) {}
+
+        [[nodiscard]] uint32_t match(const int8_t h) const noexcept {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < ARENA_HASH_MAP_GROUP_WIDTH; ++i) {
+                mask |= static_cast<uint32_t>(pos[i] == h) << i;
+            }
+            return mask;
+        }
+
+        [[nodiscard]] uint32_t match_non_full() const noexcept {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < ARENA_HASH_MAP_GROUP_WIDTH; ++i) {
+                mask |= static_cast<uint32_t>(pos[i] < 0) << i;
+            }
+            return mask;
+        }
+#endif
+
+        [[nodiscard]] uint32_t match_empty() const noexcept {return match(CTRL_EMPTY);}
+    };
+
+    ArenaV2* arena;
+    [[no_unique_address]] Hash hasher;
+    [[no_unique_address]] KeyEqual key_eq;
+    char* table = nullptr;
+    value_type* slots = nullptr;
+    int8_t* ctrl = nullptr;
+    size_t n_capacity = 0;
+    size_t n_size = 0;
+    size_t growth_left = 0;
+
+    /**
+     * Arena epoch `table` was allocated in.
+     */
+    uint64_t epoch = 0;
+
+    static constexpr size_t max_load(const size_t capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    static constexpr size_t table_bytes(const size_t capacity) noexcept {
+        return capacity * sizeof(value_type) + capacity;
+    }
+
+    static constexpr size_t group_start(const size_t idx) noexcept {
+        return idx & ~(ARENA_HASH_MAP_GROUP_WIDTH - 1);
+    }
+
+    /**
+     * @return Hash of `key`, mixed so that identity hashes (e.g. `std::hash<int>`) spread over every bit.
+     */
+    [[nodiscard]] size_t hash_of(const K& key) const noexcept {
+        uint64_t h = static_cast<uint64_t>(hasher(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return static_cast<size_t>(h);
+    }
+
+    /** @return Control byte of a full slot: the low 7 bits of the hash. */
+    static constexpr int8_t h2(const size_t hash) noexcept {
+        return static_cast<int8_t>(hash & 0x7f);
+    }
+
+    /** @return First group of the probe sequence, chosen by the bits above `h2`. */
+    [[nodiscard]] size_t first_group(const size_t hash) const noexcept {
+        return (hash >> 7) & (n_capacity / ARENA_HASH_MAP_GROUP_WIDTH - 1);
+    }
+
+    iterator iterator_at(const size_t idx) noexcept {
+        return iterator(ctrl + idx, ctrl + n_capacity, slots + idx);
+    }
+
+    /**
+     * @return Index of the slot holding `key`, or `NOT_FOUND`.
+     *
+     * Groups are probed with triangular steps, visiting every group once, until one with an empty slot.
+     */
+    [[nodiscard]] size_t find_index(const K& key, const size_t hash) const noexcept {
+        if (n_capacity == 0) return NOT_FOUND;
+
+        const size_t group_mask = n_capacity / ARENA_HASH_MAP_GROUP_WIDTH - 1;
+        size_t group = first_group(hash);
+        for (size_t step = 1;; ++step) {
+            const size_t start = group * ARENA_HASH_MAP_GROUP_WIDTH;
+            const Group g(ctrl + start);
+            for (uint32_t mask = g.match(h2(hash)); mask; mask &= mask - 1) {
+                const size_t idx = start + static_cast<size_t>(std::countr_zero(mask));
+                if (key_eq(slots[idx].first, key)) [[likely]] return idx;
+            }
+            if (g.match_empty()) return NOT_FOUND;
+            group = (group + step) & group_mask;
+        }
+    }
+
+    /**
+     * @return Index of the first empty or deleted slot along the probe sequence of `hash`.
+     */
+    [[nodiscard]] size_t find_first_non_full(const size_t hash) const noexcept {
+        const size_t group_mask = n_capacity / ARENA_HASH_MAP_GROUP_WIDTH - 1;
+        size_t group = first_group(hash);
+        for (size_t step = 1;; ++step) {
+            const size_t start = group * ARENA_HASH_MAP_GROUP_WIDTH;
+            if (const uint32_t mask = Group(ctrl + start).match_non_full()) {
+                return start + static_cast<size_t>(std::countr_zero(mask));
+            }
+            group = (group + step) & group_mask;
+        }
+    }
+
+    /**
+     * @brief Moves the element at `src` into the uninitialised slot `dst`.
+     */
+    static void relocate(value_type* dst, value_type* src) noexcept(std::is_nothrow_copy_constructible_v<K> &&
+                                                                     std::is_nothrow_move_constructible_v<V>) {
+        if constexpr (std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>) {
+            std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(value_type));
+        } else {
+            new (dst) value_type(src->first, std::move(src->second));
+            src->~value_type();
+        }
+    }
+
+    /**
+     * @brief Makes room for more elements: rehashes at the same size if tombstones take much of the table,
+     * otherwise doubles it.
+     *
+     * Kept out of line since growth is rare compared to insertion.
+     */
+    __attribute__((noinline))
+    void grow() {
+        if (n_capacity && n_size <= n_capacity * 7 / 16) {
+            resize(n_capacity);
+            return;
+        }
+        resize(n_capacity ? n_capacity * 2 : ARENA_HASH_MAP_MIN_CAPACITY);
+    }
+
+    /**
+     * @brief Rehashes into a table of `capacity` slots.
+     *
+     * When the table is the arena's latest allocation, it is extended to make room for the new table right after it.
+     * The elements are rehashed into that room, then the new table slides down over the old one and the tail
+     * goes back to the arena, so growth leaves no dead table behind. Otherwise the elements move to a fresh table.
+     */
+    void resize(const size_t capacity) {
+        if (capacity > std::numeric_limits<size_t>::max() / (2 * (sizeof(value_type) + 1))) {
+            throw std::bad_array_new_length();
+        }
+
+        const size_t old_bytes = table_bytes(n_capacity);
+        const size_t new_bytes = table_bytes(capacity);
+        const size_t offset = (old_bytes + alignof(value_type) - 1) & ~(alignof(value_type) - 1);
+
+        if (char* base = table; base && arena->try_extend(base, old_bytes, offset + new_bytes, epoch)) {
+            rehash_into(base + offset, capacity);
+
+            // slots move down in ascending order, each source lies past every destination written before it.
+            auto* dst = reinterpret_cast<value_type*>(base);
+            for (size_t idx = 0; idx < capacity; ++idx) {
+                if (ctrl[idx] >= 0) relocate(dst + idx, slots + idx);
+            }
+            std::memmove(base + capacity * sizeof(value_type), ctrl, capacity);
+
+            set_table(base, capacity);
+            arena->try_extend(base, offset + new_bytes, new_bytes, epoch);
+            return;
+        }
+
+        // the fresh table sits after the old one, which therefore cannot be handed back.
+        rehash_into(static_cast<char*>(arena->allocate_raw(new_bytes, alignof(value_type))), capacity);
+        epoch = arena->get_epoch();
+    }
+
+    /**
+     * @brief Moves every element into a new table of `capacity` slots at `fresh`, which becomes the current table.
+     */
+    void rehash_into(char* fresh, const size_t capacity) {
+        value_type* old_slots = slots;
+        const int8_t* old_ctrl = ctrl;
+        const size_t old_capacity = n_capacity;
+
+        set_table(fresh, capacity);
+        std::memset(ctrl, static_cast<unsigned char>(CTRL_EMPTY), capacity);
+
+        for (size_t idx = 0; idx < old_capacity; ++idx) {
+            if (old_ctrl[idx] < 0) continue;
+            const size_t hash = hash_of(old_slots[idx].first);
+            const size_t target = find_first_non_full(hash);
+            relocate(slots + target, old_slots + idx);
+            ctrl[target] = h2(hash);
+        }
+        growth_left = max_load(n_capacity) - n_size;
+    }
+
+    void set_table(char* base, const size_t capacity) noexcept {
+        table = base;
+        slots = reinterpret_cast<value_type*>(base);
+        ctrl = reinterpret_cast<int8_t*>(base + capacity * sizeof(value_type));
+        n_capacity = capacity;
+    }
+
+    void destroy_elements() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_t idx = 0; idx < n_capacity; ++idx) {
+                if (ctrl[idx] >= 0) slots[idx].~value_type();
+            }
+        }
+    }
+
+    void release() noexcept {
+        destroy_elements();
+        if (table) arena->deallocate_raw(table, table_bytes(n_capacity), epoch);
+        forget();
+    }
+
+    void forget() noexcept {
+        table = nullptr;
+        slots = nullptr;
+        ctrl = nullptr;
+        n_capacity = 0;
+        n_size = 0;
+        growth_left = 0;
+    }
+};
+
+#endif //ARENA_HASH_MAP_H
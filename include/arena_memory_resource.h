@@ -0,0 +1,51 @@
+#ifndef ARENA_MEMORY_RESOURCE_H
+#define ARENA_MEMORY_RESOURCE_H
+
+#include <memory_resource>
+#include "arena.h"
+
+/**
+ * @class ArenaMemoryResource
+ * @brief `std::pmr::memory_resource` adapter over an `ArenaV2`.
+ *
+ * Lets `std::pmr` containers allocate from the arena without carrying `ArenaAllocator<T>` in their type,
+ * so every `std::pmr::vector<T>` stays one type regardless of where its memory comes from.
+ * Frees are ignored as with `ArenaAllocator`: a container outliving a `clear()` would otherwise hand back
+ * a stale buffer that could match the new cycle's latest allocation and roll the arena back over live data.
+ *
+ * The class is `final`, so calls made through an `ArenaMemoryResource&` (rather than a `memory_resource*`)
+ * are devirtualised and inlined down to the arena's bump-pointer fast path.
+ *
+ * @code
+ * ArenaV2 arena(65536);
+ * ArenaMemoryResource resource(arena);
+ * std::pmr::vector<int> vec(&resource);
+ * @endcode
+ *
+ * @note The arena must outlive the resource, and the resource every container using it.
+ */
+class ArenaMemoryResource final : public std::pmr::memory_resource {
+public:
+    explicit ArenaMemoryResource(ArenaV2& arena) noexcept : arena(&arena) {}
+
+    ArenaMemoryResource(const ArenaMemoryResource&) = delete;
+    ArenaMemoryResource& operator=(const ArenaMemoryResource&) = delete;
+
+    /** @return Arena memory is drawn from. */
+    [[nodiscard]] ArenaV2& get_arena() const noexcept {return *arena;}
+
+private:
+    ArenaV2* arena;
+
+    void* do_allocate(const size_t bytes, const size_t alignment) override {
+        return arena->allocate_raw(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+#endif //ARENA_MEMORY_RESOURCE_H
@@ -0,0 +1,162 @@
+#ifndef ARENA_PROFILE_H
+#define ARENA_PROFILE_H
+
+#include <array>
+#include <bit>
+#include <cinttypes>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "arena.h"
+
+inline constexpr size_t ARENA_PROFILE_SIZE_CLASSES = 48;
+
+/**
+ * @brief Aggregated samples of one allocation site, see `ArenaSiteProfile`.
+ */
+struct ArenaSiteStats {
+    /** Allocated type, empty for untyped requests. */
+    std::string_view type_name;
+
+    /** Source file of the site, empty unless allocated through `create_at()`. */
+    std::string_view file_name;
+
+    /** Function of the site, empty unless allocated through `create_at()`. */
+    std::string_view function_name;
+
+    /** Line of the site, 0 unless allocated through `create_at()`. */
+    uint_least32_t line = 0;
+
+    /** Number of samples taken at the site. */
+    size_t n_samples = 0;
+
+    /** Estimated bytes allocated at the site, the sum of its samples' `sampled_bytes`. */
+    size_t sampled_bytes = 0;
+
+    /** Samples per request size class, class `i > 0` holds sizes in `[2^(i-1), 2^i)`, the last class everything larger. */
+    std::array<size_t, ARENA_PROFILE_SIZE_CLASSES> size_histogram{};
+};
+
+/**
+ * @class ArenaSiteProfile
+ * @brief Thread-safe `ArenaProfiler` hook aggregating samples per allocation site (type and call site).
+ *
+ * @code
+ * ArenaSiteProfile profile;
+ * profile.install(64 * 1024);
+ * run_workload();
+ * profile.write_report(stderr);
+ * @endcode
+ *
+ * @note Sites are only sampled in builds with `ARENA_PROFILE`.
+ */
+class ArenaSiteProfile {
+public:
+    ArenaSiteProfile() = default;
+
+    ArenaSiteProfile(const ArenaSiteProfile&) = delete;
+    ArenaSiteProfile& operator=(const ArenaSiteProfile&) = delete;
+
+    /**
+     * @brief Uninstalls the profile if it is still the installed hook.
+     */
+    ~ArenaSiteProfile() {
+        if (ArenaProfiler::get_user_data() == this) ArenaProfiler::uninstall();
+    }
+
+    /**
+     * @brief Installs this profile as the process' `ArenaProfiler` hook.
+     */
+    void install(const size_t sample_interval = DEFAULT_ARENA_PROFILE_SAMPLE_INTERVAL) noexcept {
+        ArenaProfiler::install(&on_sample, this, sample_interval);
+    }
+
+    /**
+     * @brief Folds one sample into its site. Samples that cannot be stored for lack of memory are dropped.
+     */
+    void record(const ArenaAllocationSample& sample) noexcept {
+        const SiteKey key{sample.type_name, sample.location.file_name(), sample.location.line(),
+                          sample.location.function_name()};
+        const std::lock_guard lock(mutex);
+
+        try {
+            auto [it, inserted] = sites.try_emplace(key);
+            ArenaSiteStats& site = it->second;
+            if (inserted) {
+                site.type_name = sample.type_name;
+                site.file_name = std::get<1>(key);
+                site.line = sample.location.line();
+                site.function_name = std::get<3>(key);
+            }
+
+            site.n_samples++;
+            site.sampled_bytes += sample.sampled_bytes;
+            site.size_histogram[std::min<size_t>(std::bit_width(sample.size), ARENA_PROFILE_SIZE_CLASSES - 1)]++;
+        } catch (const std::bad_alloc&) {
+        }
+    }
+
+    /**
+     * @return Every site sampled so far, largest `sampled_bytes` first.
+     */
+    [[nodiscard]] std::vector<ArenaSiteStats> get_sites() const {
+        std::vector<ArenaSiteStats> result;
+        {
+            const std::lock_guard lock(mutex);
+            result.reserve(sites.size());
+            for (const auto& [key, site] : sites) {
+                result.push_back(site);
+            }
+        }
+
+        std::stable_sort(result.begin(), result.end(), [](const ArenaSiteStats& a, const ArenaSiteStats& b) {
+            return a.sampled_bytes > b.sampled_bytes;
+        });
+        return result;
+    }
+
+    /**
+     * @brief Forgets every site.
+     */
+    void reset() {
+        const std::lock_guard lock(mutex);
+        sites.clear();
+    }
+
+    /**
+     * @brief Writes one line per site, largest first, followed by its non-empty size classes.
+     */
+    void write_report(std::FILE* out) const {
+        for (const ArenaSiteStats& site : get_sites()) {
+            const std::string_view type_name = site.type_name.empty() ? std::string_view("(raw)") : site.type_name;
+            std::fprintf(out, "%12zu bytes %8zu samples  %.*s", site.sampled_bytes, site.n_samples,
+                         static_cast<int>(type_name.size()), type_name.data());
+            if (site.line != 0) {
+                std::fprintf(out, "  %.*s:%" PRIuLEAST32 " (%.*s)",
+                             static_cast<int>(site.file_name.size()), site.file_name.data(), site.line,
+                             static_cast<int>(site.function_name.size()), site.function_name.data());
+            }
+            std::fprintf(out, "\n");
+
+            for (size_t cls = 0; cls < ARENA_PROFILE_SIZE_CLASSES; ++cls) {
+                if (site.size_histogram[cls] == 0) continue;
+                const size_t smallest = cls == 0 ? 0 : size_t{1} << (cls - 1);
+                std::fprintf(out, "%14s>= %zu bytes: %zu\n", "", smallest, site.size_histogram[cls]);
+            }
+        }
+    }
+
+private:
+    using SiteKey = std::tuple<std::string_view, std::string_view, uint_least32_t, std::string_view>;
+
+    mutable std::mutex mutex;
+    std::map<SiteKey, ArenaSiteStats> sites;
+
+    static void on_sample(const ArenaAllocationSample& sample, void* self) {
+        static_cast<ArenaSiteProfile*>(self)->record(sample);
+    }
+};
+
+#endif //ARENA_PROFILE_H
@@ -0,0 +1,195 @@
+#ifndef ARENA_STRING_H
+#define ARENA_STRING_H
+
+#include <functional>
+#include <string_view>
+#include "arena.h"
+
+inline constexpr size_t ARENA_INTERNER_INITIAL_CAPACITY = 64;
+
+/**
+ * @class ArenaString
+ * @brief Immutable string whose bytes live in an `ArenaV2`, held through a single pointer.
+ *
+ * The length is stored in front of the bytes and the bytes are NUL-terminated, so an `ArenaString` is
+ * the size of a pointer, trivially copyable and destructible, and never registers a destructor.
+ * It has no small-string buffer and no allocator, every string is one bump allocation.
+ *
+ * @code
+ * ArenaV2 arena;
+ * ArenaString name(arena, "identifier");
+ * std::string_view view = name;
+ * @endcode
+ *
+ * @note Like any arena allocation, the string is invalidated by `clear()`.
+ */
+class ArenaString {
+public:
+    /** Empty string, no allocation. */
+    constexpr ArenaString() noexcept = default;
+
+    /**
+     * @brief Copies `str` into `arena`.
+     */
+    ArenaString(ArenaV2& arena, const std::string_view str) noexcept {
+        char* record = static_cast<char*>(arena.allocate_raw(sizeof(size_t) + str.size() + 1, alignof(size_t)));
+        const size_t size = str.size();
+        std::memcpy(record, &size, sizeof(size_t));
+
+        chars = record + sizeof(size_t);
+        if (!str.empty()) std::memcpy(chars, str.data(), str.size());
+        chars[str.size()] = '\0';
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        if (!chars) return 0;
+        size_t size;
+        std::memcpy(&size, chars - sizeof(size_t), sizeof(size_t));
+        return size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {return size() == 0;}
+
+    [[nodiscard]] const char* data() const noexcept {return chars ? chars : "";}
+
+    /** @return NUL-terminated bytes of the string. */
+    [[nodiscard]] const char* c_str() const noexcept {return data();}
+
+    [[nodiscard]] std::string_view view() const noexcept {return {data(), size()};}
+
+    operator std::string_view() const noexcept {return view();}
+
+    /**
+     * @brief Compares contents, strings sharing their bytes (e.g. from one `ArenaInterner`) compare in O(1).
+     */
+    bool operator==(const ArenaString& other) const noexcept {
+        return chars == other.chars || view() == other.view();
+    }
+
+private:
+    char* chars = nullptr;
+};
+
+/**
+ * @class ArenaInterner
+ * @brief Deduplicating string table whose hash table and string bytes both live in an `ArenaV2`.
+ *
+ * `intern()` returns the same `ArenaString` for equal contents, so interned identifiers can be
+ * compared and hashed by `data()` pointer. The table is open-addressed with linear probing, storing each string's hash
+ * to skip most byte comparisons, and doubles into a fresh arena allocation whenever it is three quarters full.
+ *
+ * @code
+ * ArenaV2 arena(1 << 16);
+ * ArenaInterner interner(arena);
+ * ArenaString a = interner.intern("token");
+ * ArenaString b = interner.intern(std::string("token"));
+ * assert(a.data() == b.data());
+ * @endcode
+ *
+ * @warning ArenaInterner is **not thread-safe**, and is invalidated with everything else by the arena's `clear()`.
+ */
+class ArenaInterner {
+public:
+    /**
+     * @param arena Arena holding the table and the strings.
+     * @param initial_capacity Number of slots to start with, rounded up to a power of two.
+     */
+    explicit ArenaInterner(ArenaV2& arena, const size_t initial_capacity = ARENA_INTERNER_INITIAL_CAPACITY) :
+        arena(arena) {
+        capacity = 1;
+        while (capacity < initial_capacity) capacity <<= 1;
+        slots = allocate_slots(capacity);
+    }
+
+    ArenaInterner(const ArenaInterner&) = delete;
+    ArenaInterner& operator=(const ArenaInterner&) = delete;
+
+    /**
+     * @return The interned copy of `str`, copying it into the arena on first sight.
+     */
+    ArenaString intern(const std::string_view str) {
+        const size_t hash = std::hash<std::string_view>{}(str);
+        Slot* slot = probe(slots, capacity, hash, str);
+        if (slot->occupied) return slot->str;
+
+        if ((n_strings + 1) * 4 > capacity * 3) [[unlikely]] {
+            grow();
+            slot = probe(slots, capacity, hash, str);
+        }
+
+        *slot = Slot{hash, ArenaString(arena, str), true};
+        n_strings++;
+        return slot->str;
+    }
+
+    /**
+     * @return The interned copy of `str`, or an empty string if `str` was never interned.
+     */
+    [[nodiscard]] ArenaString find(const std::string_view str) const noexcept {
+        return probe(slots, capacity, std::hash<std::string_view>{}(str), str)->str;
+    }
+
+    /** @return Whether `str` has been interned. */
+    [[nodiscard]] bool contains(const std::string_view str) const noexcept {
+        return probe(slots, capacity, std::hash<std::string_view>{}(str), str)->occupied;
+    }
+
+    /** @return Number of distinct strings interned. */
+    [[nodiscard]] size_t size() const noexcept {return n_strings;}
+
+    /** @return Number of slots of the hash table. */
+    [[nodiscard]] size_t get_capacity() const noexcept {return capacity;}
+
+    /** @return Arena holding the table and the strings. */
+    [[nodiscard]] ArenaV2& get_arena() const noexcept {return arena;}
+
+private:
+    /**
+     * @brief Hash table slot, `occupied` tells an interned empty string apart from a free slot.
+     */
+    struct Slot {
+        size_t hash;
+        ArenaString str;
+        bool occupied;
+    };
+
+    ArenaV2& arena;
+    Slot* slots = nullptr;
+    size_t capacity = 0;
+    size_t n_strings = 0;
+
+    Slot* allocate_slots(const size_t n) {
+        Slot* table = arena.allocate<Slot>(n);
+        std::uninitialized_value_construct_n(table, n);
+        return table;
+    }
+
+    /**
+     * @return Slot holding `str`, or the free slot it would be inserted into.
+     */
+    static Slot* probe(Slot* table, const size_t n_slots, const size_t hash, const std::string_view str) noexcept {
+        for (size_t idx = hash & (n_slots - 1);; idx = (idx + 1) & (n_slots - 1)) {
+            Slot& slot = table[idx];
+            if (!slot.occupied || (slot.hash == hash && slot.str.view() == str)) return &slot;
+        }
+    }
+
+    /**
+     * @brief Doubles the table. The old one stays in the arena, the tables left behind add up to less than the current one.
+     */
+    void grow() {
+        const size_t new_capacity = capacity * 2;
+        Slot* table = allocate_slots(new_capacity);
+
+        for (size_t idx = 0; idx < capacity; ++idx) {
+            if (slots[idx].occupied) {
+                *probe(table, new_capacity, slots[idx].hash, slots[idx].str.view()) = slots[idx];
+            }
+        }
+
+        slots = table;
+        capacity = new_capacity;
+    }
+};
+
+#endif //ARENA_STRING_H
@@ -0,0 +1,266 @@
+#ifndef ARENA_VECTOR_H
+#define ARENA_VECTOR_H
+
+#include <initializer_list>
+#include <type_traits>
+#include "arena.h"
+
+inline constexpr size_t ARENA_VECTOR_MIN_CAPACITY = 4;
+
+/**
+ * @class ArenaVector
+ * @brief Growable array allocated from an `ArenaV2`, growing in place whenever it is the arena's latest allocation.
+ *
+ * `std::vector<T, ArenaAllocator<T>>` leaves every outgrown buffer behind in the arena, pushing `n` elements
+ * wastes about `n` elements of dead capacity. `ArenaVector` first tries `ArenaV2::try_extend` to grow its buffer
+ * in place, and only relocates when another allocation sits after it or the block is full.
+ * On relocation or destruction the buffer is handed back with `deallocate_raw`, reclaimed if it is still the latest
+ * allocation of the epoch it was allocated in (`ArenaV2::get_epoch()`), so a vector outliving a `clear()`
+ * never rolls back the new cycle's allocations.
+ *
+ * @tparam T Element type.
+ *
+ * @note Elements are destroyed with the vector; memory is reclaimed by the arena.
+ */
+template<typename T>
+class ArenaVector {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    explicit ArenaVector(ArenaV2& arena) noexcept : arena(&arena) {}
+
+    ArenaVector(ArenaV2& arena, const std::initializer_list<T> init) : arena(&arena) {
+        reserve(init.size());
+        for (const T& v : init) {
+            push_back(v);
+        }
+    }
+
+    ~ArenaVector() {
+        release();
+    }
+
+    ArenaVector(const ArenaVector&) = delete;
+    ArenaVector& operator=(const ArenaVector&) = delete;
+
+    ArenaVector(ArenaVector&& other) noexcept :
+        arena(other.arena), elems(other.elems), n_size(other.n_size), n_capacity(other.n_capacity), epoch(other.epoch) {
+        other.elems = nullptr;
+        other.n_size = 0;
+        other.n_capacity = 0;
+    }
+
+    ArenaVector& operator=(ArenaVector&& other) noexcept {
+        if (this != &other) {
+            release();
+            arena = other.arena;
+            elems = other.elems;
+            n_size = other.n_size;
+            n_capacity = other.n_capacity;
+            epoch = other.epoch;
+            other.elems = nullptr;
+            other.n_size = 0;
+            other.n_capacity = 0;
+        }
+        return *this;
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template<typename ...Args>
+    T& emplace_back(Args&& ... args) {
+        if (n_size == n_capacity) [[unlikely]] return grow_emplace_back(std::forward<Args>(args)...);
+
+        T* obj = new (elems + n_size) T(std::forward<Args>(args)...);
+        n_size++;
+        return *obj;
+    }
+
+    void pop_back() noexcept {
+        elems[--n_size].~T();
+    }
+
+    /**
+     * @brief Ensures capacity for at least `n` elements.
+     */
+    void reserve(const size_t n) {
+        if (n > n_capacity) grow(n);
+    }
+
+    /**
+     * @brief Resizes to `n` elements, value-initialising new ones.
+     */
+    void resize(const size_t n) {
+        reserve(n);
+        while (n_size < n) {
+            emplace_back();
+        }
+        while (n_size > n) {
+            pop_back();
+        }
+    }
+
+    /**
+     * @brief Destroys every element, capacity is kept.
+     */
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = n_size; i > 0; i--) {
+                elems[i - 1].~T();
+            }
+        }
+        n_size = 0;
+    }
+
+    T& operator[](const size_t i) noexcept {return elems[i];}
+    const T& operator[](const size_t i) const noexcept {return elems[i];}
+
+    T& front() noexcept {return elems[0];}
+    T& back() noexcept {return elems[n_size - 1];}
+
+    T* data() noexcept {return elems;}
+    const T* data() const noexcept {return elems;}
+
+    iterator begin() noexcept {return elems;}
+    iterator end() noexcept {return elems + n_size;}
+    const_iterator begin() const noexcept {return elems;}
+    const_iterator end() const noexcept {return elems + n_size;}
+
+    [[nodiscard]] size_t size() const noexcept {return n_size;}
+    [[nodiscard]] size_t capacity() const noexcept {return n_capacity;}
+    [[nodiscard]] bool empty() const noexcept {return n_size == 0;}
+
+private:
+    ArenaV2* arena;
+    T* elems = nullptr;
+    size_t n_size = 0;
+    size_t n_capacity = 0;
+
+    /**
+     * Arena epoch `elems` was allocated in.
+     */
+    uint64_t epoch = 0;
+
+    void release() noexcept {
+        clear();
+        if (elems) arena->deallocate_raw(elems, n_capacity * sizeof(T), epoch);
+        elems = nullptr;
+        n_capacity = 0;
+    }
+
+    /**
+     * @brief Grows capacity to `new_capacity`, in place if possible.
+     *
+     * Kept out of line since growth is rare compared to `emplace_back`.
+     */
+    __attribute__((noinline))
+    void grow(const size_t new_capacity) {
+        if (try_grow_in_place(new_capacity)) return;
+
+        T* fresh = allocate_elems(new_capacity);
+        try {
+            relocate(fresh, new_capacity);
+        } catch (...) {
+            arena->deallocate_raw(fresh, new_capacity * sizeof(T));
+            throw;
+        }
+    }
+
+    /**
+     * @brief Slow path of `emplace_back()` on a full vector.
+     *
+     * When the buffer moves, the new element is constructed before the old ones are relocated,
+     * so the arguments may refer to elements of the vector itself, as with `v.push_back(v[0])`.
+     */
+    template<typename ...Args>
+    __attribute__((noinline))
+    T& grow_emplace_back(Args&& ... args) {
+        const size_t new_capacity = n_capacity ? n_capacity * 2 : ARENA_VECTOR_MIN_CAPACITY;
+
+        if (try_grow_in_place(new_capacity)) {
+            new (elems + n_size) T(std::forward<Args>(args)...);
+            return elems[n_size++];
+        }
+
+        T* fresh = allocate_elems(new_capacity);
+        try {
+            new (fresh + n_size) T(std::forward<Args>(args)...);
+        } catch (...) {
+            arena->deallocate_raw(fresh, new_capacity * sizeof(T));
+            throw;
+        }
+
+        try {
+            relocate(fresh, new_capacity);
+        } catch (...) {
+            fresh[n_size].~T();
+            arena->deallocate_raw(fresh, new_capacity * sizeof(T));
+            throw;
+        }
+        return elems[n_size++];
+    }
+
+    /**
+     * @return Whether the buffer could be extended to `new_capacity` elements where it is.
+     */
+    bool try_grow_in_place(const size_t new_capacity) {
+        if (new_capacity > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+
+        if (elems && arena->try_extend(elems, n_capacity * sizeof(T), new_capacity * sizeof(T), epoch)) {
+            n_capacity = new_capacity;
+            return true;
+        }
+        return false;
+    }
+
+    T* allocate_elems(const size_t new_capacity) {
+        return static_cast<T*>(arena->allocate_raw(new_capacity * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief Moves the elements into `fresh`, a buffer of `new_capacity` elements just allocated,
+     * and releases the old buffer.
+     *
+     * The old elements are destroyed only once every element is in `fresh`, so when a throwing copy fails
+     * the vector is left unchanged and `fresh` holds nothing.
+     */
+    void relocate(T* fresh, const size_t new_capacity) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (n_size) std::memcpy(fresh, elems, n_size * sizeof(T));
+        } else {
+            size_t n_relocated = 0;
+            try {
+                for (; n_relocated < n_size; ++n_relocated) {
+                    new (fresh + n_relocated) T(std::move_if_noexcept(elems[n_relocated]));
+                }
+            } catch (...) {
+                for (; n_relocated > 0; n_relocated--) {
+                    fresh[n_relocated - 1].~T();
+                }
+                throw;
+            }
+
+            for (size_t i = n_size; i > 0; i--) {
+                elems[i - 1].~T();
+            }
+        }
+
+        if (elems) arena->deallocate_raw(elems, n_capacity * sizeof(T), epoch);
+        elems = fresh;
+        n_capacity = new_capacity;
+        epoch = arena->get_epoch();
+    }
+};
+
+#endif //ARENA_VECTOR_H
@@ -0,0 +1,178 @@
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <atomic>
+#include <bit>
+#include "arena.h"
+
+inline constexpr size_t BLOCK_CACHE_MIN_CLASS_SHIFT = 10;
+inline constexpr size_t BLOCK_CACHE_MAX_CLASS_SHIFT = 26;
+inline constexpr size_t BLOCK_CACHE_N_CLASSES = BLOCK_CACHE_MAX_CLASS_SHIFT - BLOCK_CACHE_MIN_CLASS_SHIFT + 1;
+inline constexpr size_t DEFAULT_BLOCK_CACHE_HIGH_WATER_MARK = 64 * 1024 * 1024;
+
+/**
+ * @class BlockCache
+ * @brief Opt-in block source that recycles released blocks through thread-local size-class free lists.
+ *
+ * Short-lived arenas normally pay one `::operator new` per block on construction and one `::operator delete`
+ * per block on destruction. With the block cache, released blocks are pushed onto the calling thread's free list
+ * for their size class, and the next arena on that thread pops them back without a system call.
+ *
+ * Block sizes are rounded up to a power of two between `1 << BLOCK_CACHE_MIN_CLASS_SHIFT` and
+ * `1 << BLOCK_CACHE_MAX_CLASS_SHIFT`. Larger blocks bypass the cache.
+ * Each thread caches at most `get_high_water_mark()` bytes, anything beyond is returned to the heap.
+ *
+ * @code
+ * ArenaV2 arena(ArenaOptions{.block_size = 8192, .source = BlockCache::instance()});
+ * @endcode
+ *
+ * @note Blocks released on another thread are cached by that thread, the lists never synchronise.
+ * `ArenaV2::clear_async()` therefore releases blocks of this source on the caller's thread.
+ */
+class BlockCache : public BlockSource {
+public:
+    /**
+     * @brief Cache statistics of the calling thread.
+     */
+    struct ThreadStats {
+        size_t hits;
+        size_t misses;
+        size_t cached_bytes;
+        size_t cached_blocks;
+    };
+
+    /**
+     * @return The process-wide block cache.
+     */
+    static BlockCache* instance() noexcept {
+        static BlockCache cache;
+        return &cache;
+    }
+
+    /**
+     * @brief Sets the maximum bytes each thread may keep cached.
+     */
+    static void set_high_water_mark(const size_t bytes) noexcept {
+        high_water_mark.store(bytes, std::memory_order_relaxed);
+    }
+
+    /** @return Maximum bytes each thread may keep cached. */
+    [[nodiscard]] static size_t get_high_water_mark() noexcept {
+        return high_water_mark.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns cached blocks of the calling thread to the heap until at most `keep_bytes` remain cached.
+     *
+     * Largest size classes are released first.
+     */
+    static void trim(const size_t keep_bytes = 0) noexcept {
+        ThreadLists& lists = thread_lists;
+        for (size_t cls = BLOCK_CACHE_N_CLASSES; cls > 0 && lists.cached_bytes > keep_bytes; cls--) {
+            while (lists.heads[cls - 1] && lists.cached_bytes > keep_bytes) {
+                FreeBlock* block = lists.heads[cls - 1];
+                lists.heads[cls - 1] = block->next;
+                lists.cached_bytes -= class_size(cls - 1);
+                lists.cached_blocks--;
+                ::operator delete(block);
+            }
+        }
+    }
+
+    /** @return Cache statistics of the calling thread. */
+    [[nodiscard]] static ThreadStats get_thread_stats() noexcept {
+        const ThreadLists& lists = thread_lists;
+        return ThreadStats{lists.hits, lists.misses, lists.cached_bytes, lists.cached_blocks};
+    }
+
+private:
+    constexpr BlockCache() noexcept : BlockSource{.allocate_fn = &cache_allocate, .deallocate_fn = &cache_deallocate, .thread_agnostic = false} {}
+
+    /**
+     * @brief Intrusive free-list node stored inside the released block.
+     */
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    /**
+     * @brief Free lists of one thread.
+     *
+     * Trivially destructible so the lists stay usable while other thread-locals are torn down,
+     * `ThreadReaper` releases the cached blocks at thread exit and marks the lists as closed.
+     */
+    struct ThreadLists {
+        FreeBlock* heads[BLOCK_CACHE_N_CLASSES];
+        size_t cached_bytes;
+        size_t cached_blocks;
+        size_t hits;
+        size_t misses;
+        bool closed;
+    };
+
+    struct ThreadReaper {
+        ~ThreadReaper() {
+            trim(0);
+            thread_lists.closed = true;
+        }
+    };
+
+    static inline std::atomic<size_t> high_water_mark{DEFAULT_BLOCK_CACHE_HIGH_WATER_MARK};
+    static inline thread_local ThreadLists thread_lists;
+    static inline thread_local ThreadReaper thread_reaper;
+
+    static constexpr size_t class_size(const size_t cls) noexcept {
+        return size_t{1} << (cls + BLOCK_CACHE_MIN_CLASS_SHIFT);
+    }
+
+    /**
+     * @return Size class servicing `size`, or `BLOCK_CACHE_N_CLASSES` if it is too large to cache.
+     */
+    static size_t class_of(const size_t size) noexcept {
+        const size_t shift = std::bit_width(std::max(size, size_t{1} << BLOCK_CACHE_MIN_CLASS_SHIFT) - 1);
+        return std::min(shift - BLOCK_CACHE_MIN_CLASS_SHIFT, BLOCK_CACHE_N_CLASSES);
+    }
+
+    static void* cache_allocate(BlockSource*, size_t& size) noexcept {
+        const size_t cls = class_of(size);
+        if (cls == BLOCK_CACHE_N_CLASSES) [[unlikely]] {
+            return ::operator new(size, std::nothrow);
+        }
+
+        size = class_size(cls);
+        ThreadLists& lists = thread_lists;
+
+        if (FreeBlock* block = lists.heads[cls]) {
+            lists.heads[cls] = block->next;
+            lists.cached_bytes -= size;
+            lists.cached_blocks--;
+            lists.hits++;
+            return block;
+        }
+
+        // touching the reaper registers its thread-exit destructor before anything is cached.
+        (void) &thread_reaper;
+        lists.misses++;
+        return ::operator new(size, std::nothrow);
+    }
+
+    static void cache_deallocate(BlockSource*, void* ptr, const size_t size) noexcept {
+        const size_t cls = class_of(size);
+        ThreadLists& lists = thread_lists;
+
+        if (cls == BLOCK_CACHE_N_CLASSES || lists.closed ||
+            lists.cached_bytes + size > high_water_mark.load(std::memory_order_relaxed)) {
+            ::operator delete(ptr);
+            return;
+        }
+
+        (void) &thread_reaper;
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = lists.heads[cls];
+        lists.heads[cls] = block;
+        lists.cached_bytes += size;
+        lists.cached_blocks++;
+    }
+};
+
+#endif //BLOCK_CACHE_H
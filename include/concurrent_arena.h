@@ -0,0 +1,548 @@
+#ifndef CONCURRENT_ARENA_H
+#define CONCURRENT_ARENA_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "arena.h"
+
+inline constexpr size_t DEFAULT_CONCURRENT_BLOCK_SIZE = 64 * 1024;
+inline constexpr size_t ATOMIC_ARENA_GRANULE = alignof(void*);
+
+/**
+ * @class ConcurrentArena
+ * @brief A thread-safe, bump-pointer arena where every thread allocates from its own slab.
+ *
+ * Each thread that allocates from the arena owns a private slab (a whole block) and bumps through it
+ * without synchronisation, keeping the fast path as short as `ArenaV2`'s.
+ * Shared state is only touched when a thread needs a new slab:
+ *  1. Blocks retained by `clear()` are popped off a lock-free free list.
+ *  2. Otherwise a new block is requested from the system and pushed onto the block list with a CAS.
+ *
+ * Destructors are registered per thread, in chunks carved from the thread's own slab,
+ * so `create<T>` never contends with other threads.
+ *
+ * @warning `clear()` and destruction must not run concurrently with allocation.
+ * @warning Destruction order is LIFO per thread; no ordering is guaranteed across threads.
+ * @note ConcurrentArena is neither copyable nor movable, threads keep references to their slabs.
+ */
+class ConcurrentArena {
+public:
+    /**
+     * @brief Constructs an arena whose slabs are `block_size` bytes.
+     *
+     * No memory is requested until the first allocation.
+     *
+     * @param block_size Size (in bytes) of each slab handed to a thread.
+     */
+    explicit ConcurrentArena(const size_t block_size = DEFAULT_CONCURRENT_BLOCK_SIZE) noexcept :
+        block_size(block_size),
+        id(next_arena_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+    /**
+     * @brief Destroys all allocated objects and returns every block to the system.
+     */
+    ~ConcurrentArena() {
+        clear();
+
+        BlockHeader* block = blocks.load(std::memory_order_acquire);
+        while (block) {
+            BlockHeader* next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+
+        ThreadState* state = states.load(std::memory_order_acquire);
+        while (state) {
+            ThreadState* next = state->next;
+            delete state;
+            state = next;
+        }
+    }
+
+    ConcurrentArena(const ConcurrentArena&) = delete;
+    ConcurrentArena& operator=(const ConcurrentArena&) = delete;
+    ConcurrentArena(ConcurrentArena&&) = delete;
+    ConcurrentArena& operator=(ConcurrentArena&&) = delete;
+
+    /**
+    * @brief Constructs an object of type `T` within the calling thread's slab.
+    *
+    * @tparam T Type of object to construct.
+    * @tparam Args Constructor parameter types.
+    * @param args Arguments forwarded to `T`'s constructor.
+    *
+    * @return Pointer to the constructed object.
+    */
+    template<typename T, typename ...Args>
+    T* create(Args&& ... args) {
+        ThreadState& state = local_state();
+        void* ptr = allocate(state, sizeof(T), alignof(T));
+        T* obj = new (ptr) T(std::forward<Args>(args)...);
+
+        if constexpr (!std::is_trivially_destructible_v<T> && !arena_skip_destroy_v<T>) {
+            append_new_destructor(state, obj, &destruct<T>);
+        }
+
+        return obj;
+    }
+
+    /**
+     * @brief Allocates raw memory with user-specified alignment from the calling thread's slab.
+     *
+     * @param size Number of bytes to allocate.
+     * @param align Required alignment.
+     *
+     * @return Pointer to an aligned memory region within the arena.
+     */
+    void* allocate_raw(const size_t size, const size_t align) noexcept {
+        return allocate(local_state(), size, align);
+    }
+
+    /**
+    * @brief Destroys registered objects of every thread and retains all blocks for reuse.
+    *
+    * @warning Must not run concurrently with any allocation from this arena.
+    */
+    void clear() {
+        for (ThreadState* state = states.load(std::memory_order_acquire); state; state = state->next) {
+            DestructorChunk* curr = state->destructor_block_latest;
+            while (curr) {
+                for (size_t i = curr->n_nodes; i > 0; i--) {
+                    curr->nodes[i - 1].fn(curr->nodes[i - 1].obj);
+                }
+                curr = curr->prev;
+            }
+
+            state->destructor_block_latest = nullptr;
+            state->cursor = nullptr;
+            state->end = nullptr;
+        }
+
+        // quiescent, so the free list can be rebuilt without contention.
+        BlockHeader* free_head = nullptr;
+        for (BlockHeader* block = blocks.load(std::memory_order_acquire); block; block = block->next) {
+            block->next_free = free_head;
+            free_head = block;
+        }
+        free_blocks.store(free_head, std::memory_order_release);
+    }
+
+    /** @return Total bytes of all allocated blocks. */
+    [[nodiscard]] size_t get_arena_size() const {return arena_size.load(std::memory_order_relaxed);}
+
+    /** @return Default bytes of a newly created slab. */
+    [[nodiscard]] size_t get_single_block_size() const {return block_size;}
+
+    /** @return Number of blocks allocated so far. */
+    [[nodiscard]] size_t get_number_of_allocated_blocks() const {return n_blocks.load(std::memory_order_relaxed);}
+
+private:
+    template<typename T>
+    static void destruct(void* p) noexcept {
+        static_cast<T*>(p)->~T();
+    }
+
+    struct DestructorNode {
+        void (*fn)(void*);
+        void* obj;
+    };
+
+    struct DestructorChunk {
+        DestructorNode nodes[DESTRUCTOR_CHUNK_SIZE]{};
+        size_t n_nodes = 0;
+        DestructorChunk* prev{};
+    };
+
+    /**
+     * @brief Header placed at the front of every block.
+     *
+     * `next` links every block the arena owns (push-only while allocating).
+     * `next_free` links blocks retained by `clear()` (pop-only while allocating, so the free list is ABA-free).
+     */
+    struct alignas(std::max_align_t) BlockHeader {
+        BlockHeader* next;
+        BlockHeader* next_free;
+        size_t size;
+
+        [[nodiscard]] char* data() noexcept {return reinterpret_cast<char*>(this + 1);}
+    };
+
+    /**
+     * @brief Bump region and destructor list owned by exactly one thread.
+     */
+    struct ThreadState {
+        char* cursor = nullptr;
+        char* end = nullptr;
+        DestructorChunk* destructor_block_latest = nullptr;
+        std::thread::id owner;
+        ThreadState* next = nullptr;
+    };
+
+    /**
+     * @brief One-entry per-thread cache of the thread's state in the most recently used arena.
+     *
+     * Arenas are identified by a unique id rather than their address, so a new arena constructed
+     * at the address of a destroyed one never observes stale state.
+     * Zero-initialised as a thread-local, and id 0 is never assigned to an arena.
+     */
+    struct ThreadCache {
+        uint64_t arena_id;
+        ThreadState* state;
+    };
+
+    static inline std::atomic<uint64_t> next_arena_id{1};
+    static inline thread_local ThreadCache thread_cache;
+
+    /**
+     * Every block owned by the arena.
+     */
+    std::atomic<BlockHeader*> blocks{nullptr};
+
+    /**
+     * Blocks retained by `clear()` that have not been handed to a thread yet.
+     */
+    std::atomic<BlockHeader*> free_blocks{nullptr};
+
+    /**
+     * Every thread that has allocated from the arena.
+     */
+    std::atomic<ThreadState*> states{nullptr};
+
+    std::atomic<size_t> arena_size{0};
+    std::atomic<size_t> n_blocks{0};
+
+    /**
+     * Size of the slab handed to a thread.
+     */
+    size_t block_size;
+
+    /**
+     * Unique id keying `thread_cache`.
+     */
+    uint64_t id;
+
+    inline ThreadState& local_state() noexcept {
+        if (thread_cache.arena_id == id) [[likely]] {
+            return *thread_cache.state;
+        }
+        return register_thread_state();
+    }
+
+    /**
+     * @brief Finds or creates the calling thread's state and caches it.
+     */
+    __attribute__((noinline))
+    ThreadState& register_thread_state() noexcept {
+        const std::thread::id self = std::this_thread::get_id();
+
+        ThreadState* state = states.load(std::memory_order_acquire);
+        while (state && state->owner != self) {
+            state = state->next;
+        }
+
+        if (!state) {
+            state = new ThreadState();
+            state->owner = self;
+            state->next = states.load(std::memory_order_relaxed);
+            while (!states.compare_exchange_weak(state->next, state, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+
+        thread_cache.arena_id = id;
+        thread_cache.state = state;
+        return *state;
+    }
+
+    /**
+     * @brief Bump allocation from the thread's slab.
+     */
+    static inline void* bump(ThreadState& state, const size_t size, const size_t align) noexcept {
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(state.cursor) + align - 1) & ~(align - 1);
+        if (aligned + size > reinterpret_cast<uintptr_t>(state.end)) [[unlikely]] return nullptr;
+
+        state.cursor = reinterpret_cast<char*>(aligned + size);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    inline void* allocate(ThreadState& state, const size_t size, const size_t align) noexcept {
+        if (void* ptr = bump(state, size, align)) [[likely]] {
+            return ptr;
+        }
+        return refill_and_allocate(state, size, align);
+    }
+
+    /**
+     * @brief Hands the thread a new slab and retries allocation.
+     *
+     * Requests larger than a quarter of a slab get a dedicated block so the current slab is not abandoned.
+     */
+    __attribute__((noinline))
+    void* refill_and_allocate(ThreadState& state, const size_t size, const size_t align) noexcept {
+        const size_t required = size + align - 1;
+
+        if (required > block_size / 4) {
+            BlockHeader* block = new_block(std::max(required, block_size));
+            const uintptr_t aligned = (reinterpret_cast<uintptr_t>(block->data()) + align - 1) & ~(align - 1);
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        BlockHeader* block = pop_free_block();
+        if (!block) {
+            block = new_block(block_size);
+        }
+
+        state.cursor = block->data();
+        state.end = block->data() + block->size;
+        return bump(state, size, align);
+    }
+
+    /**
+     * @brief Pops a retained block, the only concurrent operation on the free list.
+     */
+    BlockHeader* pop_free_block() noexcept {
+        BlockHeader* head = free_blocks.load(std::memory_order_acquire);
+        while (head && !free_blocks.compare_exchange_weak(head, head->next_free, std::memory_order_acquire, std::memory_order_acquire)) {}
+        return head;
+    }
+
+    /**
+     * @brief Requests a block from the system and publishes it on the block list.
+     */
+    BlockHeader* new_block(const size_t size) noexcept {
+        auto* block = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + size));
+        block->size = size;
+        block->next_free = nullptr;
+        block->next = blocks.load(std::memory_order_relaxed);
+        while (!blocks.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {}
+
+        arena_size.fetch_add(size, std::memory_order_relaxed);
+        n_blocks.fetch_add(1, std::memory_order_relaxed);
+        return block;
+    }
+
+    /**
+     * @brief Registers a destructor in the calling thread's destructor list.
+     */
+    inline void append_new_destructor(ThreadState& state, void* obj, void (*fn)(void*)) noexcept {
+        if (!state.destructor_block_latest || state.destructor_block_latest->n_nodes == DESTRUCTOR_CHUNK_SIZE) [[unlikely]] {
+            void* ptr = allocate(state, sizeof(DestructorChunk), alignof(DestructorChunk));
+            DestructorChunk* dest_mb = new (ptr) DestructorChunk();
+            dest_mb->prev = state.destructor_block_latest;
+
+            state.destructor_block_latest = dest_mb;
+        }
+
+        DestructorNode& node = state.destructor_block_latest->nodes[state.destructor_block_latest->n_nodes++];
+        node.fn = fn;
+        node.obj = obj;
+    }
+};
+
+/**
+ * @class AtomicArena
+ * @brief A lock-free, bump-pointer arena where every thread bumps the same block.
+ *
+ * Intended for one large, pre-sized arena filled by many threads at once.
+ * Allocation reserves space with a single `fetch_add` on the block offset:
+ *  1. Sizes are rounded up to `ATOMIC_ARENA_GRANULE`, so every offset stays granule-aligned and
+ *     requests with `align <= ATOMIC_ARENA_GRANULE` need no padding.
+ *  2. Larger alignments reserve `align - 1` extra bytes and align inside the reservation,
+ *     using the same bit masking as `ArenaV2`.
+ *
+ * Only block rollover, which should be rare for a well-sized arena, installs a new block with a CAS.
+ *
+ * @warning Only trivially destructible objects can be created, no destructors are registered.
+ * @warning `clear()` and destruction must not run concurrently with allocation.
+ */
+class AtomicArena {
+public:
+    /**
+     * @brief Constructs an arena with a pre-sized first block.
+     *
+     * @param capacity Size (in bytes) of the first block, retained across `clear()`.
+     * @param block_size Size (in bytes) of blocks added on rollover, defaults to `capacity`.
+     */
+    explicit AtomicArena(const size_t capacity, const size_t block_size = 0) :
+        block_size(block_size ? block_size : capacity) {
+        first_block = new_block(capacity, nullptr);
+        current.store(first_block, std::memory_order_release);
+    }
+
+    /**
+     * @brief Returns every block to the system.
+     */
+    ~AtomicArena() {
+        release_blocks(current.load(std::memory_order_acquire), nullptr);
+        release_blocks(large_blocks.load(std::memory_order_acquire), nullptr);
+    }
+
+    AtomicArena(const AtomicArena&) = delete;
+    AtomicArena& operator=(const AtomicArena&) = delete;
+    AtomicArena(AtomicArena&&) = delete;
+    AtomicArena& operator=(AtomicArena&&) = delete;
+
+    /**
+    * @brief Constructs a trivially destructible object of type `T` within the arena.
+    *
+    * @return Pointer to the constructed object.
+    */
+    template<typename T, typename ...Args>
+    T* create(Args&& ... args) {
+        static_assert(std::is_trivially_destructible_v<T> || arena_skip_destroy_v<T>,
+            "AtomicArena does not register destructors, use ConcurrentArena for non-trivially destructible types.");
+        void* ptr = allocate_raw(sizeof(T), alignof(T));
+        return new (ptr) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Allocates raw memory with user-specified alignment, safe to call from any thread.
+     *
+     * @param size Number of bytes to allocate.
+     * @param align Required alignment.
+     *
+     * @return Pointer to an aligned memory region within the arena.
+     */
+    void* allocate_raw(const size_t size, const size_t align) noexcept {
+        const size_t rounded = (size + ATOMIC_ARENA_GRANULE - 1) & ~(ATOMIC_ARENA_GRANULE - 1);
+        const size_t reserve = align <= ATOMIC_ARENA_GRANULE ? rounded : rounded + align - 1;
+
+        Block* block = current.load(std::memory_order_acquire);
+        while (true) {
+            const size_t offset = block->offset.fetch_add(reserve, std::memory_order_relaxed);
+
+            if (offset + reserve <= block->size) [[likely]] {
+                const uintptr_t curr = reinterpret_cast<uintptr_t>(block->data() + offset);
+                return reinterpret_cast<void*>((curr + align - 1) & ~(align - 1));
+            }
+
+            block = rollover(block, reserve);
+            if (!block) {
+                return allocate_large(size, align);
+            }
+        }
+    }
+
+    /**
+    * @brief Resets the arena to its first block and returns every other block to the system.
+    *
+    * @warning Must not run concurrently with any allocation from this arena.
+    */
+    void clear() noexcept {
+        release_blocks(current.load(std::memory_order_acquire), first_block);
+        release_blocks(large_blocks.exchange(nullptr, std::memory_order_acq_rel), nullptr);
+
+        first_block->offset.store(0, std::memory_order_relaxed);
+        current.store(first_block, std::memory_order_release);
+        arena_size.store(first_block->size, std::memory_order_relaxed);
+        n_blocks.store(1, std::memory_order_relaxed);
+    }
+
+    /** @return Total bytes of all allocated blocks. */
+    [[nodiscard]] size_t get_arena_size() const {return arena_size.load(std::memory_order_relaxed);}
+
+    /** @return Default bytes of a block added on rollover. */
+    [[nodiscard]] size_t get_single_block_size() const {return block_size;}
+
+    /** @return Number of blocks allocated so far. */
+    [[nodiscard]] size_t get_number_of_allocated_blocks() const {return n_blocks.load(std::memory_order_relaxed);}
+
+private:
+    /**
+     * @brief Header placed at the front of every block, blocks are chained from newest to oldest.
+     */
+    struct alignas(std::max_align_t) Block {
+        std::atomic<size_t> offset;
+        size_t size;
+        Block* next;
+
+        [[nodiscard]] char* data() noexcept {return reinterpret_cast<char*>(this + 1);}
+    };
+
+    /**
+     * Block all threads currently bump.
+     */
+    std::atomic<Block*> current{nullptr};
+
+    /**
+     * Dedicated blocks for requests too large for a regular block.
+     */
+    std::atomic<Block*> large_blocks{nullptr};
+
+    /**
+     * Pre-sized block retained across `clear()`.
+     */
+    Block* first_block;
+
+    std::atomic<size_t> arena_size{0};
+    std::atomic<size_t> n_blocks{0};
+
+    /**
+     * Size of blocks added on rollover.
+     */
+    size_t block_size;
+
+    Block* new_block(const size_t size, Block* next) noexcept {
+        auto* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+        new (&block->offset) std::atomic<size_t>(0);
+        block->size = size;
+        block->next = next;
+
+        arena_size.fetch_add(size, std::memory_order_relaxed);
+        n_blocks.fetch_add(1, std::memory_order_relaxed);
+        return block;
+    }
+
+    void release_blocks(Block* block, const Block* stop) noexcept {
+        while (block != stop) {
+            Block* next = block->next;
+            arena_size.fetch_sub(block->size, std::memory_order_relaxed);
+            n_blocks.fetch_sub(1, std::memory_order_relaxed);
+            ::operator delete(block);
+            block = next;
+        }
+    }
+
+    /**
+     * @brief Installs a fresh block once `full` is exhausted.
+     *
+     * Threads racing to roll over the same block each build a candidate, one wins the CAS and the rest
+     * discard theirs and continue on the winner.
+     *
+     * @return Block to retry on, or nullptr if the request should get a dedicated block.
+     */
+    __attribute__((noinline))
+    Block* rollover(Block* full, const size_t reserve) noexcept {
+        if (reserve > block_size / 2) {
+            return nullptr;
+        }
+
+        Block* curr = current.load(std::memory_order_acquire);
+        if (curr != full) {
+            return curr;
+        }
+
+        Block* fresh = new_block(block_size, full);
+        if (current.compare_exchange_strong(curr, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return fresh;
+        }
+
+        arena_size.fetch_sub(fresh->size, std::memory_order_relaxed);
+        n_blocks.fetch_sub(1, std::memory_order_relaxed);
+        ::operator delete(fresh);
+        return curr;
+    }
+
+    /**
+     * @brief Services an oversized request from its own block, pushed onto `large_blocks` with a CAS.
+     */
+    __attribute__((noinline))
+    void* allocate_large(const size_t size, const size_t align) noexcept {
+        Block* block = new_block(size + align - 1, large_blocks.load(std::memory_order_relaxed));
+        while (!large_blocks.compare_exchange_weak(block->next, block, std::memory_order_release, std::memory_order_relaxed)) {}
+
+        const uintptr_t curr = reinterpret_cast<uintptr_t>(block->data());
+        return reinterpret_cast<void*>((curr + align - 1) & ~(align - 1));
+    }
+};
+
+#endif //CONCURRENT_ARENA_H
@@ -0,0 +1,160 @@
+#ifndef MAPPED_ARENA_H
+#define MAPPED_ARENA_H
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "mapped_arena.h requires a POSIX platform"
+#endif
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "arena.h"
+
+/**
+ * @class MappedArena
+ * @brief Read-only view of a file written by `ArenaV2::snapshot()`, mapped with `mmap`.
+ *
+ * Resolves the `arena_ptr`s stored in the snapshot straight against the mapping, nothing is copied or fixed up,
+ * so reloading a large structure costs only the page faults of the parts that are read.
+ *
+ * @code
+ * ArenaV2 arena(1 << 20);
+ * Trie* trie = build_trie(arena);
+ * arena.snapshot(fd, arena.to_arena_ptr(trie));
+ *
+ * MappedArena mapped(fd);
+ * const Trie* loaded = mapped.root<Trie>();
+ * @endcode
+ *
+ * @note The mapping stays valid after the file descriptor is closed.
+ */
+class MappedArena {
+public:
+    /**
+     * @brief Maps the snapshot held by `fd` from its start.
+     *
+     * @throws std::system_error if the file cannot be inspected or mapped.
+     * @throws std::invalid_argument if the file is not a snapshot this build can read.
+     */
+    explicit MappedArena(const int fd) {
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) throw std::system_error(errno, std::generic_category(), "fstat");
+
+        size = static_cast<size_t>(st.st_size);
+        if (size < sizeof(ArenaSnapshotHeader)) throw std::invalid_argument("file is not an arena snapshot");
+
+        void* ptr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) throw std::system_error(errno, std::generic_category(), "mmap");
+        base = static_cast<const char*>(ptr);
+
+        if (!validate()) {
+            ::munmap(const_cast<char*>(base), size);
+            throw std::invalid_argument("file is not an arena snapshot");
+        }
+    }
+
+    ~MappedArena() {
+        if (base) ::munmap(const_cast<char*>(base), size);
+    }
+
+    MappedArena(const MappedArena&) = delete;
+    MappedArena& operator=(const MappedArena&) = delete;
+
+    MappedArena(MappedArena&& other) noexcept : base(other.base), size(other.size) {
+        other.base = nullptr;
+        other.size = 0;
+    }
+
+    MappedArena& operator=(MappedArena&& other) noexcept {
+        if (this != &other) {
+            if (base) ::munmap(const_cast<char*>(base), size);
+            base = other.base;
+            size = other.size;
+            other.base = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @return Object `ptr` refers to within the snapshot, nullptr if `ptr` is null or, read from a corrupt file,
+     * does not lie within one of the snapshot's blocks.
+     */
+    template<typename T>
+    [[nodiscard]] const T* resolve(const arena_ptr<T> ptr) const noexcept {
+        if (!ptr) return nullptr;
+        return static_cast<const T*>(locate(ptr.block_index(), ptr.block_offset(), 1, sizeof(T)));
+    }
+
+    /**
+     * @return Array `span` refers to within the snapshot, empty if it does not lie within one of the snapshot's blocks.
+     */
+    template<typename T>
+    [[nodiscard]] std::span<const T> resolve(const arena_span<T>& span) const noexcept {
+        if (!span.data) return {};
+
+        const void* first = locate(span.data.block_index(), span.data.block_offset(), span.size, sizeof(T));
+        if (!first) return {};
+        return {static_cast<const T*>(first), span.size};
+    }
+
+    /**
+     * @return Root object passed to `ArenaV2::snapshot()`, read as a `T`.
+     */
+    template<typename T>
+    [[nodiscard]] const T* root() const noexcept {
+        return resolve(arena_ptr<T>::from_raw(header().root));
+    }
+
+    /** @return Number of blocks in the snapshot. */
+    [[nodiscard]] size_t get_number_of_blocks() const noexcept {return header().n_blocks;}
+
+    /** @return Bytes of the mapping. */
+    [[nodiscard]] size_t get_mapped_size() const noexcept {return size;}
+
+private:
+    const char* base = nullptr;
+    size_t size = 0;
+
+    [[nodiscard]] const ArenaSnapshotHeader& header() const noexcept {
+        return *reinterpret_cast<const ArenaSnapshotHeader*>(base);
+    }
+
+    [[nodiscard]] const ArenaSnapshotBlock* blocks() const noexcept {
+        return reinterpret_cast<const ArenaSnapshotBlock*>(base + sizeof(ArenaSnapshotHeader));
+    }
+
+    /**
+     * @return Address of `count` objects of `object_size` bytes at `offset` into block `block_index`,
+     * nullptr unless they lie within that block. Block indices and offsets come from the file, so both are checked.
+     */
+    [[nodiscard]] const void* locate(const size_t block_index, const size_t offset, const size_t count,
+                                     const size_t object_size) const noexcept {
+        if (block_index >= header().n_blocks) return nullptr;
+
+        const ArenaSnapshotBlock& block = blocks()[block_index];
+        if (offset > block.size) return nullptr;
+        if (object_size && count > (block.size - offset) / object_size) return nullptr;
+        return base + block.file_offset + offset;
+    }
+
+    /**
+     * @brief Checks the header and that every block lies within the mapping.
+     */
+    [[nodiscard]] bool validate() const noexcept {
+        const ArenaSnapshotHeader& h = header();
+        if (std::memcmp(h.magic, ARENA_SNAPSHOT_MAGIC, sizeof(h.magic)) != 0) return false;
+        if (h.version != ARENA_SNAPSHOT_VERSION || h.file_size != size) return false;
+        if ((size - sizeof(ArenaSnapshotHeader)) / sizeof(ArenaSnapshotBlock) < h.n_blocks) return false;
+
+        for (size_t idx = 0; idx < h.n_blocks; ++idx) {
+            const ArenaSnapshotBlock& block = blocks()[idx];
+            if (block.file_offset > size || block.size > size - block.file_offset) return false;
+        }
+        return true;
+    }
+};
+
+#endif //MAPPED_ARENA_H
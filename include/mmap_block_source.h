@@ -0,0 +1,204 @@
+#ifndef MMAP_BLOCK_SOURCE_H
+#define MMAP_BLOCK_SOURCE_H
+
+#if !defined(__unix__) && !defined(__APPLE__)
+#error "mmap_block_source.h requires a POSIX platform"
+#endif
+
+#include <cstdint>
+#include <limits>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "arena.h"
+
+inline constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+inline constexpr size_t DEFAULT_RESERVED_BLOCK_SIZE = sizeof(void*) >= 8 ? size_t{64} << 30 : size_t{1} << 30;
+
+/**
+ * @brief Options of an `MmapBlockSource`.
+ */
+struct MmapBlockOptions {
+    /**
+     * Back blocks with 2 MiB pages to cut dTLB misses on large arenas.
+     * Tries `MAP_HUGETLB` first (needs reserved huge pages), then falls back to regular pages
+     * advised with `MADV_HUGEPAGE` so transparent huge pages can back them.
+     */
+    bool huge_pages = false;
+
+    /**
+     * Pre-fault every page with `MAP_POPULATE`, moving page-fault cost to block creation.
+     */
+    bool populate = false;
+};
+
+/**
+ * @class MmapBlockSource
+ * @brief Block source mapping every block directly with `mmap`, bypassing `malloc`.
+ *
+ * Block sizes are rounded up to the page size, or to `HUGE_PAGE_SIZE` when huge pages are requested,
+ * and the arena uses the rounded size in full.
+ *
+ * @code
+ * MmapBlockSource source({.huge_pages = true});
+ * ArenaV2 arena(ArenaOptions{.block_size = 64 * 1024 * 1024, .source = &source});
+ * @endcode
+ */
+class MmapBlockSource : public BlockSource {
+public:
+    explicit MmapBlockSource(const MmapBlockOptions& options = {}) noexcept :
+        BlockSource{&mmap_allocate, &mmap_deallocate},
+        options(options),
+        page_size(static_cast<size_t>(::sysconf(_SC_PAGESIZE))) {}
+
+    [[nodiscard]] const MmapBlockOptions& get_options() const noexcept {return options;}
+
+private:
+    MmapBlockOptions options;
+    size_t page_size;
+
+    static size_t round_up(const size_t size, const size_t granularity) noexcept {
+        return (size + granularity - 1) & ~(granularity - 1);
+    }
+
+    static void* map(const size_t size, const int extra_flags) noexcept {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+    static void* mmap_allocate(BlockSource* self, size_t& size) noexcept {
+        const auto* source = static_cast<MmapBlockSource*>(self);
+
+        int flags = 0;
+#ifdef MAP_POPULATE
+        if (source->options.populate) flags |= MAP_POPULATE;
+#endif
+
+        if (!source->options.huge_pages) {
+            size = round_up(size, source->page_size);
+            return map(size, flags);
+        }
+
+        size = round_up(size, HUGE_PAGE_SIZE);
+
+#ifdef MAP_HUGETLB
+        if (void* ptr = map(size, flags | MAP_HUGETLB)) {
+            return ptr;
+        }
+#endif
+
+        // transparent huge pages only back 2 MiB-aligned ranges, so over-map and trim to alignment.
+        char* raw = static_cast<char*>(map(size + HUGE_PAGE_SIZE, flags));
+        if (!raw) return nullptr;
+
+        char* aligned = reinterpret_cast<char*>(round_up(reinterpret_cast<uintptr_t>(raw), HUGE_PAGE_SIZE));
+        if (const size_t head = aligned - raw; head > 0) ::munmap(raw, head);
+        if (const size_t tail = HUGE_PAGE_SIZE - (aligned - raw); tail > 0) ::munmap(aligned + size, tail);
+
+#ifdef MADV_HUGEPAGE
+        ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+        return aligned;
+    }
+
+    static void mmap_deallocate(BlockSource*, void* ptr, const size_t size) noexcept {
+        ::munmap(ptr, size);
+    }
+};
+
+/**
+ * @brief Options of a `ReservedBlockSource`.
+ */
+struct ReservedBlockOptions {
+    /**
+     * Address space reserved per block. Only committed pages count towards memory usage,
+     * so this can far exceed physical memory on 64-bit platforms.
+     */
+    size_t reserve_size = DEFAULT_RESERVED_BLOCK_SIZE;
+
+    /**
+     * Bytes of each block kept resident across `clear()`, pages past it are returned to the OS
+     * with `MADV_DONTNEED`. Pages stay committed, they are simply refaulted as zeroes when reused.
+     * The default keeps everything resident.
+     */
+    size_t retain_bytes = std::numeric_limits<size_t>::max();
+};
+
+/**
+ * @class ReservedBlockSource
+ * @brief Block source reserving a large virtual range per block and committing pages as the arena grows.
+ *
+ * Each block reserves `reserve_size` bytes of `PROT_NONE` address space and commits only what the arena asks for.
+ * When the block fills up, the arena extends it in place (`BlockSource::extend_fn`) by the next block size
+ * instead of starting a new block, so the arena stays one contiguous region with no tail waste.
+ * A new block is only started once the reservation is exhausted.
+ *
+ * @code
+ * ReservedBlockSource source({.retain_bytes = 16 * 1024 * 1024});
+ * ArenaV2 arena(ArenaOptions{.block_size = 1 << 20, .source = &source});
+ * @endcode
+ */
+class ReservedBlockSource : public BlockSource {
+public:
+    explicit ReservedBlockSource(const ReservedBlockOptions& options = {}) noexcept :
+        BlockSource{&reserved_allocate, &reserved_deallocate, &reserved_extend, &reserved_discard},
+        options(options),
+        page_size(static_cast<size_t>(::sysconf(_SC_PAGESIZE))) {}
+
+    [[nodiscard]] const ReservedBlockOptions& get_options() const noexcept {return options;}
+
+private:
+    ReservedBlockOptions options;
+    size_t page_size;
+
+    static size_t round_up(const size_t size, const size_t granularity) noexcept {
+        return (size + granularity - 1) & ~(granularity - 1);
+    }
+
+    /**
+     * @return Bytes reserved for a block of `committed` bytes, only blocks requested beyond `reserve_size` differ.
+     */
+    [[nodiscard]] size_t reservation_size(const size_t committed) const noexcept {
+        return std::max(round_up(options.reserve_size, page_size), committed);
+    }
+
+    static void* reserved_allocate(BlockSource* self, size_t& size) noexcept {
+        const auto* source = static_cast<ReservedBlockSource*>(self);
+        size = round_up(size, source->page_size);
+        const size_t reserved = source->reservation_size(size);
+
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+        flags |= MAP_NORESERVE;
+#endif
+        void* ptr = ::mmap(nullptr, reserved, PROT_NONE, flags, -1, 0);
+        if (ptr == MAP_FAILED) return nullptr;
+
+        if (::mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0) {
+            ::munmap(ptr, reserved);
+            return nullptr;
+        }
+        return ptr;
+    }
+
+    static void reserved_deallocate(BlockSource* self, void* ptr, const size_t size) noexcept {
+        ::munmap(ptr, static_cast<ReservedBlockSource*>(self)->reservation_size(size));
+    }
+
+    static bool reserved_extend(BlockSource* self, void* ptr, const size_t old_size, size_t& size) noexcept {
+        const auto* source = static_cast<ReservedBlockSource*>(self);
+        size = std::min(round_up(size, source->page_size), source->reservation_size(old_size));
+        if (size <= old_size) return false;
+
+        return ::mprotect(static_cast<char*>(ptr) + old_size, size - old_size, PROT_READ | PROT_WRITE) == 0;
+    }
+
+    static void reserved_discard(BlockSource* self, void* ptr, const size_t size) noexcept {
+        const auto* source = static_cast<ReservedBlockSource*>(self);
+        if (source->options.retain_bytes >= size) return;
+
+        const size_t retained = round_up(source->options.retain_bytes, source->page_size);
+        if (retained < size) ::madvise(static_cast<char*>(ptr) + retained, size - retained, MADV_DONTNEED);
+    }
+};
+
+#endif //MMAP_BLOCK_SOURCE_H
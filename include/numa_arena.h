@@ -0,0 +1,219 @@
+#ifndef NUMA_ARENA_H
+#define NUMA_ARENA_H
+
+#if !defined(__linux__)
+#error "numa_arena.h requires Linux"
+#endif
+
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "arena.h"
+#include "mmap_block_source.h"
+
+inline constexpr int NUMA_NODE_OF_CALLER = -1;
+
+// mempolicy constants, declared locally to avoid a dependency on libnuma headers.
+inline constexpr int NUMA_MPOL_PREFERRED = 1;
+inline constexpr int NUMA_MPOL_BIND = 2;
+inline constexpr unsigned NUMA_MPOL_MF_MOVE = 1u << 1;
+inline constexpr unsigned long NUMA_MAX_NODES = 8 * sizeof(unsigned long);
+
+/**
+ * @return NUMA node of the CPU the calling thread is running on, 0 if unknown.
+ */
+inline int numa_current_node() noexcept {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return 0;
+    return static_cast<int>(node);
+}
+
+/**
+ * @return Number of NUMA nodes the kernel reports as possible, 1 if unknown.
+ */
+inline int numa_node_count() noexcept {
+    FILE* f = std::fopen("/sys/devices/system/node/possible", "r");
+    if (!f) return 1;
+
+    // formatted as a range list, e.g. "0" or "0-1", the last node id bounds the count.
+    int first = 0;
+    int last = 0;
+    const int n_read = std::fscanf(f, "%d-%d", &first, &last);
+    std::fclose(f);
+
+    if (n_read == 2) return last + 1;
+    if (n_read == 1) return first + 1;
+    return 1;
+}
+
+/**
+ * @brief Options of a `NumaBlockSource`.
+ */
+struct NumaBlockOptions {
+    /** Node to place blocks on, or `NUMA_NODE_OF_CALLER` for the node of the thread adding the block. */
+    int node = NUMA_NODE_OF_CALLER;
+
+    /** Fail allocation rather than fall back to another node when the target node is out of memory. */
+    bool strict = false;
+
+    /** Mapping options of the underlying blocks. */
+    MmapBlockOptions mmap = {};
+};
+
+/**
+ * @class NumaBlockSource
+ * @brief Block source placing every block on a chosen NUMA node.
+ *
+ * Blocks are mapped by an `MmapBlockSource` and bound with `mbind` before they are touched,
+ * so bump allocations stay node-local even when a thread on another node first touches them.
+ * Binding is best-effort: where `mbind` is unavailable the block falls back to first-touch placement.
+ */
+class NumaBlockSource : public BlockSource {
+public:
+    explicit NumaBlockSource(const NumaBlockOptions& options = {}) noexcept :
+        BlockSource{&numa_allocate, &numa_deallocate},
+        mapper(options.mmap),
+        options(options) {}
+
+    /** @return Configured node, possibly `NUMA_NODE_OF_CALLER`. */
+    [[nodiscard]] int get_node() const noexcept {return options.node;}
+
+private:
+    MmapBlockSource mapper;
+    NumaBlockOptions options;
+
+    static void* numa_allocate(BlockSource* self, size_t& size) noexcept {
+        auto* source = static_cast<NumaBlockSource*>(self);
+
+        void* ptr = source->mapper.allocate(size);
+        if (!ptr) return nullptr;
+
+        const int node = source->options.node == NUMA_NODE_OF_CALLER ? numa_current_node() : source->options.node;
+        if (node >= 0 && static_cast<unsigned long>(node) < NUMA_MAX_NODES) {
+            const unsigned long node_mask = 1ul << node;
+            const int mode = source->options.strict ? NUMA_MPOL_BIND : NUMA_MPOL_PREFERRED;
+            // the kernel reads `maxnode - 1` bits of the mask.
+            ::syscall(SYS_mbind, ptr, size, mode, &node_mask, NUMA_MAX_NODES + 1, NUMA_MPOL_MF_MOVE);
+        }
+        return ptr;
+    }
+
+    static void numa_deallocate(BlockSource* self, void* ptr, const size_t size) noexcept {
+        static_cast<NumaBlockSource*>(self)->mapper.deallocate(ptr, size);
+    }
+};
+
+/**
+ * @class NumaArenaPool
+ * @brief Hands out arenas whose blocks live on the caller's NUMA node.
+ *
+ * The pool owns one `NumaBlockSource` per node. Released arenas are cleared and kept on their node's
+ * free list, so a per-request `acquire()`/`release()` pair reuses warm, node-local blocks.
+ *
+ * @code
+ * NumaArenaPool pool({.block_size = 1 << 20});
+ * ArenaV2 arena = pool.acquire();
+ * std::vector<int, ArenaAllocator<int>> vec{ArenaAllocator<int>(arena)};
+ * ...
+ * pool.release(std::move(arena));
+ * @endcode
+ *
+ * @note The pool must outlive every arena it hands out.
+ */
+class NumaArenaPool {
+public:
+    /**
+     * @param options Options of every arena, `options.source` is replaced by the node's source.
+     * @param mmap Mapping options of the node sources.
+     */
+    explicit NumaArenaPool(const ArenaOptions& options = {}, const MmapBlockOptions& mmap = {}) :
+        options(options) {
+        const int n_nodes = numa_node_count();
+        for (int node = 0; node < n_nodes; ++node) {
+            nodes.emplace_back(NumaBlockOptions{.node = node, .mmap = mmap});
+        }
+    }
+
+    NumaArenaPool(const NumaArenaPool&) = delete;
+    NumaArenaPool& operator=(const NumaArenaPool&) = delete;
+
+    /**
+     * @brief Hands out an arena local to the calling thread's node.
+     */
+    ArenaV2 acquire() {
+        return acquire(numa_current_node());
+    }
+
+    /**
+     * @brief Hands out an arena local to `node`.
+     */
+    ArenaV2 acquire(const int node) {
+        Node& n = node_at(node);
+
+        std::lock_guard lock(n.mutex);
+        if (!n.free_arenas.empty()) {
+            ArenaV2 arena = std::move(n.free_arenas.back());
+            n.free_arenas.pop_back();
+            return arena;
+        }
+
+        ArenaOptions node_options = options;
+        node_options.source = &n.source;
+        return ArenaV2(node_options);
+    }
+
+    /**
+     * @brief Clears an arena handed out by this pool and keeps it for reuse on its node.
+     *
+     * @return Whether the arena was taken, false if it was not handed out by this pool, in which case it is left untouched.
+     */
+    bool release(ArenaV2&& arena) {
+        for (Node& n : nodes) {
+            if (arena.get_block_source() == &n.source) {
+                arena.clear();
+                std::lock_guard lock(n.mutex);
+                n.free_arenas.push_back(std::move(arena));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** @return Number of NUMA nodes the pool serves. */
+    [[nodiscard]] size_t get_number_of_nodes() const noexcept {return nodes.size();}
+
+    /** @return Number of released arenas kept for `node`, node 0 when `node` is out of range as in `acquire()`. */
+    [[nodiscard]] size_t get_number_of_free_arenas(const int node) {
+        Node& n = node_at(node);
+        std::lock_guard lock(n.mutex);
+        return n.free_arenas.size();
+    }
+
+private:
+    struct Node {
+        NumaBlockSource source;
+        std::mutex mutex;
+        std::vector<ArenaV2> free_arenas;
+
+        explicit Node(const NumaBlockOptions& options) : source(options) {}
+    };
+
+    ArenaOptions options;
+
+    /**
+     * Deque keeps sources at stable addresses, arenas hold pointers to them.
+     */
+    std::deque<Node> nodes;
+
+    /**
+     * @return The node `node`, or node 0 for an unknown or negative node.
+     */
+    Node& node_at(const int node) noexcept {
+        return nodes[static_cast<size_t>(node) < nodes.size() ? static_cast<size_t>(node) : 0];
+    }
+};
+
+#endif //NUMA_ARENA_H
@@ -0,0 +1,377 @@
+#ifndef OBJECT_ARENA_H
+#define OBJECT_ARENA_H
+
+#include <iterator>
+#include <type_traits>
+#include "arena.h"
+
+/**
+ * @class ObjectArena
+ * @brief A bump allocator specialised for objects of a single type `T`, stored back to back in slabs.
+ *
+ * Every slab is an array of `T`: the stride is `sizeof(T)`, so `create()` is one compare and one increment,
+ * with no alignment math. Destructors are run by walking the slabs backwards on `clear()`, so no destructor
+ * records are stored at all, and the live objects can be scanned in allocation order with `for_each()`
+ * or a range-for loop, one contiguous run per slab.
+ *
+ * Slabs are obtained from `options.source` and sized by `options.block_size` and `options.growth`, like `ArenaV2`
+ * blocks, and are retained across `clear()`. `options.leak_destructors` skips destruction, as does
+ * `arena_skip_destroy<T>`. The adaptive and retention options do not apply.
+ *
+ * @code
+ * ObjectArena<Order> orders(ArenaOptions{.block_size = 1 << 20});
+ * orders.create(id, price);
+ * for (Order& order : orders) { ... }
+ * @endcode
+ *
+ * @warning ObjectArena is **not thread-safe**.
+ * @note All objects become invalid after `clear()` or move-assignment.
+ */
+template<typename T>
+class ObjectArena {
+    static_assert(std::is_object_v<T> && !std::is_array_v<T>, "ObjectArena holds complete object types");
+
+    template<bool Const>
+    class Iterator;
+
+public:
+    using value_type = T;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    /**
+     * @brief Constructs an object arena whose slabs span `slab_size` bytes.
+     */
+    explicit ObjectArena(const size_t slab_size = DEFAULT_BLOCK_SIZE) : ObjectArena(ArenaOptions{.block_size = slab_size}) {}
+
+    /**
+     * @brief Constructs an object arena from a set of options, see the class description for those that apply.
+     */
+    explicit ObjectArena(const ArenaOptions& options) :
+        slab_size(options.block_size),
+        next_slab_size(options.block_size),
+        growth(options.growth),
+        source(options.source),
+        leak_destructors(options.leak_destructors) {
+        add_slab(slab_size);
+    }
+
+    /**
+     * @brief Destroys every object and returns the slabs to their source.
+     */
+    ~ObjectArena() {
+        release_all();
+    }
+
+    ObjectArena(const ObjectArena&) = delete;
+    ObjectArena& operator=(const ObjectArena&) = delete;
+
+    ObjectArena(ObjectArena&& other) noexcept :
+        cursor(other.cursor),
+        slab_end(other.slab_end),
+        slabs(std::move(other.slabs)),
+        slab_latest_idx(other.slab_latest_idx),
+        slab_size(other.slab_size),
+        next_slab_size(other.next_slab_size),
+        growth(other.growth),
+        source(other.source),
+        leak_destructors(other.leak_destructors) {
+        other.forget();
+    }
+
+    ObjectArena& operator=(ObjectArena&& other) noexcept {
+        if (&other != this) {
+            release_all();
+            cursor = other.cursor;
+            slab_end = other.slab_end;
+            slabs = std::move(other.slabs);
+            slab_latest_idx = other.slab_latest_idx;
+            slab_size = other.slab_size;
+            next_slab_size = other.next_slab_size;
+            growth = other.growth;
+            source = other.source;
+            leak_destructors = other.leak_destructors;
+            other.forget();
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Constructs a `T` in the next free slot.
+     *
+     * @return Pointer to the constructed object.
+     */
+    template<typename ...Args>
+    T* create(Args&& ... args) {
+        if (cursor == slab_end) [[unlikely]] next_slab();
+
+#if ARENA_PROFILE
+        ArenaProfiler::record(sizeof(T), alignof(T), arena_type_name<T>(), std::source_location{});
+#endif
+        ARENA_UNPOISON(cursor, sizeof(T));
+        T* obj = new (cursor) T(std::forward<Args>(args)...);
+        ++cursor;
+        return obj;
+    }
+
+    /**
+     * @brief Destroys every object, last created first, and restarts from the first slab.
+     *
+     * Slabs are retained and refilled in order.
+     */
+    void clear() {
+        destroy_objects();
+        for (Slab& slab : slabs) {
+            slab.count = 0;
+            ARENA_POISON(slab.first, slab.capacity * sizeof(T));
+        }
+        slab_latest_idx = 0;
+        load_latest_slab();
+    }
+
+    /**
+     * @brief Calls `f(object)` for every live object, in allocation order.
+     */
+    template<typename F>
+    void for_each(F&& f) {
+        for (size_t idx = 0; idx < n_active_slabs(); ++idx) {
+            for (T* obj = slabs[idx].first, *last = slab_last(idx); obj != last; ++obj) {
+                f(*obj);
+            }
+        }
+    }
+
+    template<typename F>
+    void for_each(F&& f) const {
+        for (size_t idx = 0; idx < n_active_slabs(); ++idx) {
+            for (const T* obj = slabs[idx].first, *last = slab_last(idx); obj != last; ++obj) {
+                f(*obj);
+            }
+        }
+    }
+
+    [[nodiscard]] iterator begin() noexcept {return iterator(this, 0);}
+    [[nodiscard]] iterator end() noexcept {return iterator();}
+    [[nodiscard]] const_iterator begin() const noexcept {return const_iterator(this, 0);}
+    [[nodiscard]] const_iterator end() const noexcept {return const_iterator();}
+
+    /** @return Number of live objects. */
+    [[nodiscard]] size_t size() const noexcept {
+        if (slabs.empty()) return 0;
+
+        size_t n = static_cast<size_t>(cursor - slabs[slab_latest_idx].first);
+        for (size_t idx = 0; idx < slab_latest_idx; ++idx) {
+            n += slabs[idx].count;
+        }
+        return n;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {return size() == 0;}
+
+    /** @return Total bytes of all slabs. */
+    [[nodiscard]] size_t get_arena_size() const noexcept {
+        size_t bytes = 0;
+        for (const Slab& slab : slabs) {
+            bytes += slab.size;
+        }
+        return bytes;
+    }
+
+    [[nodiscard]] size_t get_number_of_slabs() const noexcept {return slabs.size();}
+
+    [[nodiscard]] size_t get_slab_size() const noexcept {return slab_size;}
+
+    [[nodiscard]] BlockSource* get_block_source() const noexcept {return source;}
+
+private:
+    /**
+     * @brief One block from the source, holding `capacity` slots of `T` from `first` on.
+     */
+    struct Slab {
+        char* buffer;
+        size_t size;
+        T* first;
+        size_t capacity;
+        size_t count;
+    };
+
+    static constexpr bool needs_destructor = !std::is_trivially_destructible_v<T> && !arena_skip_destroy_v<T>;
+
+    /**
+     * Next free slot of the latest slab.
+     */
+    T* cursor = nullptr;
+
+    /**
+     * One past the last slot of the latest slab.
+     */
+    T* slab_end = nullptr;
+
+    std::vector<Slab> slabs;
+    size_t slab_latest_idx = 0;
+    size_t slab_size;
+    size_t next_slab_size;
+    ArenaGrowthPolicy growth;
+    BlockSource* source;
+    bool leak_destructors;
+
+    [[nodiscard]] size_t n_active_slabs() const noexcept {
+        return slabs.empty() ? 0 : slab_latest_idx + 1;
+    }
+
+    /**
+     * @return One past the last live object of slab `idx`, the latest slab's count being cached in `cursor`.
+     */
+    [[nodiscard]] T* slab_last(const size_t idx) const noexcept {
+        return idx == slab_latest_idx ? cursor : slabs[idx].first + slabs[idx].count;
+    }
+
+    void load_latest_slab() noexcept {
+        if (slabs.empty()) {
+            cursor = nullptr;
+            slab_end = nullptr;
+            return;
+        }
+        const Slab& slab = slabs[slab_latest_idx];
+        cursor = slab.first + slab.count;
+        slab_end = slab.first + slab.capacity;
+    }
+
+    /**
+     * @brief Appends a slab of at least `bytes` bytes, large enough for one aligned `T`, and makes it the latest.
+     */
+    void add_slab(const size_t bytes) {
+        size_t size = std::max(bytes, sizeof(T) + alignof(T) - 1);
+        char* buffer = static_cast<char*>(source->allocate(size));
+        if (!buffer) throw std::bad_alloc();
+
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(buffer) + alignof(T) - 1) & ~(alignof(T) - 1);
+        T* first = reinterpret_cast<T*>(aligned);
+        const size_t capacity = (size - (aligned - reinterpret_cast<uintptr_t>(buffer))) / sizeof(T);
+
+        try {
+            slabs.push_back(Slab{buffer, size, first, capacity, 0});
+        } catch (...) {
+            source->deallocate(buffer, size);
+            throw;
+        }
+        ARENA_POISON(buffer, size);
+
+        if (slabs.size() > 1) slabs[slab_latest_idx].count = static_cast<size_t>(cursor - slabs[slab_latest_idx].first);
+        slab_latest_idx = slabs.size() - 1;
+        load_latest_slab();
+    }
+
+    /**
+     * @brief Moves on to the next retained slab, or a new one sized by the growth policy.
+     *
+     * Marked as non-inline to keep it out of `create()`'s fast path.
+     */
+    __attribute__((noinline))
+    void next_slab() {
+        if (slab_latest_idx + 1 < slabs.size()) {
+            slabs[slab_latest_idx].count = static_cast<size_t>(cursor - slabs[slab_latest_idx].first);
+            slab_latest_idx++;
+            load_latest_slab();
+            return;
+        }
+
+        next_slab_size = growth.next(next_slab_size);
+        add_slab(next_slab_size);
+    }
+
+    /**
+     * @brief Destroys the live objects in reverse allocation order.
+     */
+    void destroy_objects() noexcept {
+        if constexpr (needs_destructor) {
+            if (leak_destructors) return;
+
+            for (size_t idx = n_active_slabs(); idx > 0; idx--) {
+                for (T* obj = slab_last(idx - 1); obj != slabs[idx - 1].first;) {
+                    (--obj)->~T();
+                }
+            }
+        }
+    }
+
+    void release_all() noexcept {
+        destroy_objects();
+        for (const Slab& slab : slabs) {
+            ARENA_UNPOISON(slab.buffer, slab.size);
+            source->deallocate(slab.buffer, slab.size);
+        }
+        slabs.clear();
+        slab_latest_idx = 0;
+        load_latest_slab();
+    }
+
+    void forget() noexcept {
+        slabs.clear();
+        slab_latest_idx = 0;
+        load_latest_slab();
+    }
+
+    /**
+     * @brief Forward iterator over the live objects, in allocation order.
+     */
+    template<bool Const>
+    class Iterator {
+        friend class ObjectArena;
+
+        using Arena = std::conditional_t<Const, const ObjectArena, ObjectArena>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        Iterator() noexcept = default;
+
+        reference operator*() const noexcept {return *obj;}
+        pointer operator->() const noexcept {return obj;}
+
+        Iterator& operator++() noexcept {
+            if (++obj == last) advance(slab_idx + 1);
+            return *this;
+        }
+
+        Iterator operator++(int) noexcept {
+            Iterator before = *this;
+            ++*this;
+            return before;
+        }
+
+        bool operator==(const Iterator& other) const noexcept {return obj == other.obj;}
+
+    private:
+        Arena* arena = nullptr;
+        size_t slab_idx = 0;
+        pointer obj = nullptr;
+        pointer last = nullptr;
+
+        Iterator(Arena* arena, const size_t first_slab) noexcept : arena(arena) {
+            advance(first_slab);
+        }
+
+        /**
+         * @brief Moves to the first object of the first non-empty slab from `idx` on, or to `end()`.
+         */
+        void advance(size_t idx) noexcept {
+            for (; idx < arena->n_active_slabs(); ++idx) {
+                if (arena->slab_last(idx) != arena->slabs[idx].first) {
+                    slab_idx = idx;
+                    obj = arena->slabs[idx].first;
+                    last = arena->slab_last(idx);
+                    return;
+                }
+            }
+            obj = nullptr;
+            last = nullptr;
+        }
+    };
+};
+
+#endif //OBJECT_ARENA_H
@@ -0,0 +1,129 @@
+#ifndef POOL_ARENA_H
+#define POOL_ARENA_H
+
+#include <iterator>
+#include "arena.h"
+
+inline constexpr size_t POOL_ARENA_GRANULE = 16;
+inline constexpr size_t POOL_ARENA_N_CLASSES = 32;
+inline constexpr size_t POOL_ARENA_MAX_CHUNK_SIZE = POOL_ARENA_GRANULE * POOL_ARENA_N_CLASSES;
+
+/**
+ * @class PoolArena
+ * @brief An `ArenaV2` with per-size-class free lists, so node-based containers reuse the nodes they erase.
+ *
+ * Requests up to `POOL_ARENA_MAX_CHUNK_SIZE` bytes are rounded up to a multiple of `POOL_ARENA_GRANULE`.
+ * Freed chunks are pushed onto an intrusive free list for their size class, with the link stored inside
+ * the freed memory, and popped before the arena is bumped again.
+ * Larger requests go straight to the arena and are not recycled: their frees carry no epoch, so rolling the arena
+ * back could hit the next cycle's allocations when a container outlives `clear()`.
+ *
+ * This gives churning containers (LRU caches, order books) malloc-like reuse at bump-pointer cost,
+ * without periodically rebuilding them to reclaim the arena.
+ *
+ * @code
+ * PoolArena pool(65536);
+ * std::map<int, int, std::less<int>, PoolArenaAllocator<std::pair<const int, int>>> map{
+ *     std::less<int>(), PoolArenaAllocator<std::pair<const int, int>>(pool)};
+ * @endcode
+ *
+ * @warning PoolArena is **not thread-safe**.
+ */
+class PoolArena {
+public:
+    explicit PoolArena(const size_t block_size = DEFAULT_BLOCK_SIZE) : arena(block_size) {}
+
+    explicit PoolArena(const ArenaOptions& options) : arena(options) {}
+
+    PoolArena(const PoolArena&) = delete;
+    PoolArena& operator=(const PoolArena&) = delete;
+
+    /**
+     * @brief Allocates from the free list of the request's size class, bumping the arena if it is empty.
+     *
+     * @param size Number of bytes to allocate.
+     * @param align Required alignment.
+     *
+     * @return Pointer to an aligned memory region within the arena.
+     */
+    void* allocate_raw(const size_t size, const size_t align) noexcept {
+        if (size > POOL_ARENA_MAX_CHUNK_SIZE) [[unlikely]] {
+            return arena.allocate_raw(size, align);
+        }
+
+        const size_t cls = class_of(size);
+        if (align <= POOL_ARENA_GRANULE) [[likely]] {
+            if (FreeChunk* chunk = free_lists[cls]) {
+                free_lists[cls] = chunk->next;
+                free_bytes -= class_size(cls);
+                return chunk;
+            }
+            return arena.allocate_raw(class_size(cls), POOL_ARENA_GRANULE);
+        }
+
+        // over-aligned chunks still span the whole class, so they can be recycled into it.
+        return arena.allocate_raw(class_size(cls), align);
+    }
+
+    /**
+     * @brief Pushes a chunk onto the free list of its size class, requests above `POOL_ARENA_MAX_CHUNK_SIZE` are ignored.
+     *
+     * @param ptr Pointer returned by `allocate_raw()` since the last `clear()`.
+     * @param size Size (in bytes) `ptr` was allocated with.
+     */
+    void deallocate_raw(void* ptr, const size_t size) noexcept {
+        if (size > POOL_ARENA_MAX_CHUNK_SIZE) [[unlikely]] return;
+
+        const size_t cls = class_of(size);
+        auto* chunk = static_cast<FreeChunk*>(ptr);
+        chunk->next = free_lists[cls];
+        free_lists[cls] = chunk;
+        free_bytes += class_size(cls);
+    }
+
+    /**
+     * @brief Empties every free list and clears the underlying arena.
+     *
+     * @warning Chunks allocated before the clear must not be freed after it, they would be recycled
+     * over memory of the new cycle.
+     */
+    void clear() {
+        std::fill(std::begin(free_lists), std::end(free_lists), nullptr);
+        free_bytes = 0;
+        arena.clear();
+    }
+
+    /** @return Underlying arena, for allocations that do not need recycling. */
+    [[nodiscard]] ArenaV2& get_arena() noexcept {return arena;}
+
+    /** @return Bytes currently held on free lists. */
+    [[nodiscard]] size_t get_free_bytes() const noexcept {return free_bytes;}
+
+private:
+    /**
+     * @brief Intrusive free-list node stored inside the freed chunk.
+     */
+    struct FreeChunk {
+        FreeChunk* next;
+    };
+
+    ArenaV2 arena;
+    FreeChunk* free_lists[POOL_ARENA_N_CLASSES]{};
+    size_t free_bytes = 0;
+
+    static constexpr size_t class_of(const size_t size) noexcept {
+        return size ? (size - 1) / POOL_ARENA_GRANULE : 0;
+    }
+
+    static constexpr size_t class_size(const size_t cls) noexcept {
+        return (cls + 1) * POOL_ARENA_GRANULE;
+    }
+};
+
+/**
+ * @brief STL-compatible allocator recycling freed nodes through a `PoolArena`.
+ */
+template<typename T>
+using PoolArenaAllocator = ArenaAllocator<T, PoolArena>;
+
+#endif //POOL_ARENA_H
@@ -3,7 +3,30 @@
 //
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <coroutine>
+#include <cstdio>
+#include <future>
+#include <list>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #include "../include/arena.h"
+#include "../include/concurrent_arena.h"
+#include "../include/mmap_block_source.h"
+#include "../include/numa_arena.h"
+#include "../include/block_cache.h"
+#include "../include/arena_vector.h"
+#include "../include/pool_arena.h"
+#include "../include/arena_memory_resource.h"
+#include "../include/mapped_arena.h"
+#include "../include/arena_string.h"
+#include "../include/arena_hash_map.h"
+#include "../include/arena_coroutine.h"
+#include "../include/arena_profile.h"
+#include "../include/object_arena.h"
 
 struct TestStruct {
     int x, y;
@@ -64,3 +87,2067 @@ TEST(ArenaTest, TestRawAllocation) {
 }
 
 
+
+TEST(ArenaTest, TestRetainedBlocksReusedAfterClear) {
+    ArenaV2 arena(64);
+
+    for (int i = 0; i < 100; ++i) {
+        arena.create<int>(i);
+    }
+
+    const size_t n_blocks = arena.get_number_of_allocated_blocks();
+    const size_t arena_size = arena.get_arena_size();
+
+    for (int cycle = 0; cycle < 10; ++cycle) {
+        arena.clear();
+        for (int i = 0; i < 100; ++i) {
+            int* p = arena.create<int>(i);
+            EXPECT_EQ(*p, i);
+        }
+    }
+
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), n_blocks);
+    EXPECT_EQ(arena.get_arena_size(), arena_size);
+}
+
+TEST(ArenaTest, TestRetainedBlockSkippedWhenTooSmall) {
+    ArenaV2 arena(64);
+
+    arena.allocate_raw(48, 8);
+    arena.allocate_raw(48, 8);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 2);
+
+    arena.clear();
+    arena.allocate_raw(48, 8);
+    arena.allocate_raw(256, 8);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 3);
+}
+
+TEST(ArenaTest, TestTrimReleasesRetainedBlocks) {
+    ArenaV2 arena(64);
+
+    for (int i = 0; i < 10; ++i) {
+        arena.allocate_raw(48, 8);
+    }
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 10);
+
+    // blocks in use are never released.
+    EXPECT_EQ(arena.trim(), 0);
+
+    arena.clear();
+    EXPECT_EQ(arena.trim(256), 6 * 64);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 4);
+    EXPECT_EQ(arena.get_arena_size(), 256);
+
+    EXPECT_EQ(arena.trim(), 3 * 64);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+
+    arena.allocate_raw(48, 8);
+    arena.allocate_raw(48, 8);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 2);
+}
+
+TEST(ArenaTest, TestClearAndRelease) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(64, ArenaGrowthPolicy::geometric(2.0));
+
+    for (int i = 0; i < 100; ++i) {
+        arena.create<TestStruct>(i, i);
+    }
+    EXPECT_GT(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_GT(arena.get_next_block_size(), 64);
+
+    arena.clear_and_release();
+    EXPECT_EQ(TestStruct::destruct_count, 100);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(arena.get_arena_size(), 64);
+    EXPECT_EQ(arena.get_next_block_size(), 64);
+
+    EXPECT_EQ(arena.create<TestStruct>(1, 2)->y, 2);
+}
+
+TEST(ArenaTest, TestRetentionReleasesIdleBlocks) {
+    ArenaV2 arena(ArenaOptions{.block_size = 64, .retention = {.idle_clears = 3, .keep_bytes = 128}});
+
+    const auto fill = [&arena](const int n_blocks) {
+        for (int i = 0; i < n_blocks; ++i) {
+            arena.allocate_raw(48, 8);
+        }
+    };
+
+    fill(10);
+    arena.clear();
+    fill(3);
+    arena.clear();
+    fill(3);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 10);
+
+    // the window that saw 10 blocks in use ends here, the next one only ever needs 3.
+    arena.clear();
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 10);
+
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        fill(3);
+        arena.clear();
+    }
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 3);
+
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        fill(1);
+        arena.clear();
+    }
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 2);
+}
+
+TEST(ArenaTest, TestChildBorrowsRetainedBlocks) {
+    ArenaV2 parent(256);
+    for (int i = 0; i < 8; ++i) {
+        parent.allocate_raw(200, 8);
+    }
+    parent.clear();
+    ASSERT_EQ(parent.get_number_of_allocated_blocks(), 8);
+
+    {
+        ChildArenaV2 child = parent.make_child();
+        EXPECT_EQ(&child.get_parent(), &parent);
+        EXPECT_EQ(parent.get_number_of_allocated_blocks(), 7);
+        EXPECT_EQ(parent.get_arena_size(), 7 * 256);
+
+        for (int i = 0; i < 3; ++i) {
+            child.allocate_raw(200, 8);
+        }
+        EXPECT_EQ(child.get_number_of_allocated_blocks(), 3);
+        EXPECT_EQ(parent.get_number_of_allocated_blocks(), 5);
+
+        // the parent keeps allocating from the blocks it did not lend out.
+        parent.allocate_raw(200, 8);
+        parent.allocate_raw(200, 8);
+        EXPECT_EQ(parent.get_number_of_allocated_blocks(), 5);
+    }
+
+    EXPECT_EQ(parent.get_number_of_allocated_blocks(), 8);
+    EXPECT_EQ(parent.get_arena_size(), 8 * 256);
+}
+
+TEST(ArenaTest, TestChildBlocksReturnToParent) {
+    ArenaV2 parent(256);
+    {
+        ChildArenaV2 child = parent.make_child(1024);
+        void* p = child.allocate_raw(900, 8);
+        std::memset(p, 0xab, 900);
+        EXPECT_EQ(parent.get_number_of_allocated_blocks(), 1);
+    }
+
+    // the child's block is retained by the parent once the child is gone.
+    EXPECT_EQ(parent.get_number_of_allocated_blocks(), 2);
+    EXPECT_EQ(parent.get_arena_size(), 256 + 1024);
+
+    parent.allocate_raw(200, 8);
+    parent.allocate_raw(900, 8);
+    EXPECT_EQ(parent.get_number_of_allocated_blocks(), 2);
+}
+
+TEST(ArenaTest, TestNestedChildrenClearReturnsIdleBlocks) {
+    ArenaV2 query(4096);
+    ChildArenaV2 op = query.make_child(1024);
+    {
+        ChildArenaV2 batch = op.make_child(256);
+        for (int i = 0; i < 6; ++i) {
+            batch.allocate_raw(200, 8);
+        }
+        EXPECT_EQ(batch.get_number_of_allocated_blocks(), 6);
+
+        batch.clear();
+        batch.allocate_raw(200, 8);
+        batch.clear();
+        EXPECT_EQ(batch.get_number_of_allocated_blocks(), 1);
+        EXPECT_EQ(op.get_number_of_allocated_blocks(), 6);
+    }
+    EXPECT_EQ(op.get_number_of_allocated_blocks(), 7);
+
+    // every block ultimately came from the outermost arena's source.
+    EXPECT_EQ(query.get_number_of_allocated_blocks(), 1);
+    op.clear();
+    EXPECT_EQ(query.get_number_of_allocated_blocks(), 7);
+}
+
+TEST(ArenaTest, TestFixedGrowthPolicy) {
+    ArenaV2 arena(64);
+
+    for (int i = 0; i < 1000; ++i) {
+        arena.allocate_raw(16, 8);
+    }
+
+    EXPECT_EQ(arena.get_next_block_size(), 64);
+    EXPECT_EQ(arena.get_arena_size(), 64 * arena.get_number_of_allocated_blocks());
+}
+
+TEST(ArenaTest, TestGeometricGrowthPolicy) {
+    ArenaV2 arena(64, ArenaGrowthPolicy::geometric(2.0, 1024));
+
+    for (int i = 0; i < 1000; ++i) {
+        arena.allocate_raw(16, 8);
+    }
+
+    // 64 + 128 + 256 + 512 + 1024 * k blocks covers 16000 bytes in far fewer blocks than fixed growth.
+    EXPECT_EQ(arena.get_next_block_size(), 1024);
+    EXPECT_LT(arena.get_number_of_allocated_blocks(), 20);
+}
+
+TEST(ArenaTest, TestCustomGrowthPolicy) {
+    ArenaV2 arena(ArenaOptions{
+        .block_size = 64,
+        .growth = ArenaGrowthPolicy::custom([](const size_t previous) { return previous + 64; })
+    });
+
+    arena.allocate_raw(64, 1);
+    arena.allocate_raw(64, 1);
+    EXPECT_EQ(arena.get_next_block_size(), 128);
+
+    arena.allocate_raw(128, 1);
+    EXPECT_EQ(arena.get_next_block_size(), 192);
+}
+
+TEST(ArenaTest, TestGrowthPolicyServicesOversizedRequest) {
+    ArenaV2 arena(64, ArenaGrowthPolicy::geometric(2.0, 256));
+
+    void* mem = arena.allocate_raw(4096, 16);
+    EXPECT_NE(mem, nullptr);
+    EXPECT_GE(arena.get_arena_size(), 64 + 4096);
+}
+
+struct ConcurrentTestStruct {
+    int x;
+    static std::atomic<int> destruct_count;
+
+    explicit ConcurrentTestStruct(const int a) : x(a) {}
+    ~ConcurrentTestStruct() { destruct_count++; }
+};
+
+std::atomic<int> ConcurrentTestStruct::destruct_count = 0;
+
+TEST(ConcurrentArenaTest, TestParallelCreate) {
+    ConcurrentTestStruct::destruct_count = 0;
+    constexpr int n_threads = 8;
+    constexpr int n_objects = 10000;
+
+    {
+        ConcurrentArena arena(4096);
+        std::vector<std::thread> threads;
+        std::atomic<int> mismatches = 0;
+
+        for (int t = 0; t < n_threads; ++t) {
+            threads.emplace_back([&arena, &mismatches, t] {
+                std::vector<ConcurrentTestStruct*> objs;
+                for (int i = 0; i < n_objects; ++i) {
+                    objs.push_back(arena.create<ConcurrentTestStruct>(t * n_objects + i));
+                }
+                for (int i = 0; i < n_objects; ++i) {
+                    if (objs[i]->x != t * n_objects + i) mismatches++;
+                }
+            });
+        }
+        for (std::thread& th : threads) th.join();
+
+        EXPECT_EQ(mismatches, 0);
+        EXPECT_EQ(ConcurrentTestStruct::destruct_count, 0);
+    }
+
+    EXPECT_EQ(ConcurrentTestStruct::destruct_count, n_threads * n_objects);
+}
+
+TEST(ConcurrentArenaTest, TestArenaAllocatorPerThreadVectors) {
+    ConcurrentArena arena(1024);
+    std::vector<std::thread> threads;
+    std::atomic<long long> total = 0;
+
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&arena, &total] {
+            std::vector<int, ArenaAllocator<int, ConcurrentArena>> vec{ArenaAllocator<int, ConcurrentArena>(arena)};
+            for (int i = 0; i < 4096; ++i) {
+                vec.push_back(i);
+            }
+            long long sum = 0;
+            for (const int v : vec) sum += v;
+            total += sum;
+        });
+    }
+    for (std::thread& th : threads) th.join();
+
+    EXPECT_EQ(total, 4LL * (4095LL * 4096LL / 2));
+}
+
+TEST(ConcurrentArenaTest, TestBlocksReusedAfterClear) {
+    ConcurrentArena arena(1024);
+
+    for (int i = 0; i < 1000; ++i) {
+        arena.allocate_raw(16, 8);
+    }
+    const size_t n_blocks = arena.get_number_of_allocated_blocks();
+
+    for (int cycle = 0; cycle < 10; ++cycle) {
+        arena.clear();
+        for (int i = 0; i < 1000; ++i) {
+            arena.allocate_raw(16, 8);
+        }
+    }
+
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), n_blocks);
+}
+
+TEST(ConcurrentArenaTest, TestLargeAllocationGetsDedicatedBlock) {
+    ConcurrentArena arena(1024);
+
+    void* small = arena.allocate_raw(16, 8);
+    void* large = arena.allocate_raw(8192, 64);
+    void* next = arena.allocate_raw(16, 8);
+
+    EXPECT_NE(large, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(large) & 63, 0);
+    EXPECT_EQ(static_cast<char*>(next) - static_cast<char*>(small), 16);
+}
+
+TEST(AtomicArenaTest, TestParallelAllocationDoesNotOverlap) {
+    constexpr int n_threads = 8;
+    constexpr int n_allocs = 5000;
+
+    AtomicArena arena(1 << 16, 1 << 12);
+    std::vector<std::vector<uint64_t*>> ptrs(n_threads);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < n_threads; ++t) {
+        threads.emplace_back([&arena, &ptrs, t] {
+            for (int i = 0; i < n_allocs; ++i) {
+                auto* p = arena.create<uint64_t>(static_cast<uint64_t>(t) * n_allocs + i);
+                ptrs[t].push_back(p);
+            }
+        });
+    }
+    for (std::thread& th : threads) th.join();
+
+    for (int t = 0; t < n_threads; ++t) {
+        for (int i = 0; i < n_allocs; ++i) {
+            EXPECT_EQ(*ptrs[t][i], static_cast<uint64_t>(t) * n_allocs + i);
+        }
+    }
+    EXPECT_GT(arena.get_number_of_allocated_blocks(), 1);
+}
+
+TEST(AtomicArenaTest, TestAlignment) {
+    AtomicArena arena(4096);
+
+    arena.allocate_raw(1, 1);
+    void* p16 = arena.allocate_raw(16, 16);
+    void* p64 = arena.allocate_raw(8, 64);
+    void* large = arena.allocate_raw(1 << 16, 128);
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p16) & 15, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p64) & 63, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(large) & 127, 0);
+}
+
+TEST(AtomicArenaTest, TestClearRetainsFirstBlock) {
+    AtomicArena arena(1024, 256);
+
+    for (int i = 0; i < 1000; ++i) {
+        arena.allocate_raw(16, 8);
+    }
+    EXPECT_GT(arena.get_number_of_allocated_blocks(), 1);
+
+    arena.clear();
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(arena.get_arena_size(), 1024);
+}
+
+TEST(ArenaTest, TestRewindRunsOnlyLaterDestructors) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(1024);
+
+    auto* keep = arena.create<TestStruct>(1, 2);
+    const ArenaV2::Marker marker = arena.mark();
+
+    for (int i = 0; i < 100; ++i) {
+        arena.create<TestStruct>(i, i);
+    }
+
+    arena.rewind(marker);
+    EXPECT_EQ(TestStruct::destruct_count, 100);
+    EXPECT_EQ(keep->x, 1);
+
+    arena.clear();
+    EXPECT_EQ(TestStruct::destruct_count, 101);
+}
+
+TEST(ArenaTest, TestRewindReusesMemory) {
+    ArenaV2 arena(64);
+
+    arena.create<int>(1);
+    const ArenaV2::Marker marker = arena.mark();
+    int* first = arena.create<int>(2);
+
+    for (int i = 0; i < 100; ++i) {
+        arena.create<int>(i);
+    }
+    const size_t n_blocks = arena.get_number_of_allocated_blocks();
+    EXPECT_GT(n_blocks, 1);
+
+    arena.rewind(marker);
+    EXPECT_EQ(arena.create<int>(3), first);
+
+    for (int i = 0; i < 100; ++i) {
+        arena.create<int>(i);
+    }
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), n_blocks);
+}
+
+TEST(ArenaTest, TestNestedScopedFrames) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(256);
+
+    arena.create<TestStruct>(0, 0);
+    {
+        ScopedArenaFrame outer(arena);
+        arena.create<TestStruct>(1, 1);
+        {
+            ScopedArenaFrame inner(arena);
+            for (int i = 0; i < 50; ++i) {
+                arena.create<TestStruct>(i, i);
+            }
+        }
+        EXPECT_EQ(TestStruct::destruct_count, 50);
+    }
+    EXPECT_EQ(TestStruct::destruct_count, 51);
+
+    arena.clear();
+    EXPECT_EQ(TestStruct::destruct_count, 52);
+}
+
+struct ThrowingStruct {
+    static int construct_count;
+    static int destruct_count;
+
+    ThrowingStruct() {
+        if (construct_count == 3) throw std::runtime_error("constructor failure");
+        construct_count++;
+    }
+    ~ThrowingStruct() { destruct_count++; }
+};
+
+int ThrowingStruct::construct_count = 0;
+int ThrowingStruct::destruct_count = 0;
+
+TEST(ArenaTest, TestCreateArray) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(1024);
+
+    TestStruct* arr = arena.create_array<TestStruct>(100, 7, 8);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(arr[i].x, 7);
+        EXPECT_EQ(arr[i].y, 8);
+    }
+
+    arena.clear();
+    EXPECT_EQ(TestStruct::destruct_count, 100);
+}
+
+TEST(ArenaTest, TestCreateArrayOfStrings) {
+    ArenaV2 arena(1024);
+
+    std::string* arr = arena.create_array<std::string>(10000, "a string long enough to defeat SSO");
+    EXPECT_EQ(arr[0], "a string long enough to defeat SSO");
+    EXPECT_EQ(arr[9999], "a string long enough to defeat SSO");
+
+    // one destructor record for the whole array, rather than one DestructorChunk per 32 strings.
+    EXPECT_LT(arena.get_arena_size() - 10000 * sizeof(std::string), 4096);
+}
+
+TEST(ArenaTest, TestCreateArrayUninitialized) {
+    ArenaV2 arena(1024);
+
+    int* arr = arena.create_array_uninitialized<int>(64);
+    for (int i = 0; i < 64; ++i) arr[i] = i;
+    EXPECT_EQ(arr[63], 63);
+
+    auto* strings = arena.create_array_uninitialized<std::string>(4);
+    EXPECT_TRUE(strings[3].empty());
+
+    EXPECT_EQ(arena.create_array<int>(0), nullptr);
+}
+
+TEST(ArenaTest, TestCreateArrayThrowingConstructor) {
+    ThrowingStruct::construct_count = 0;
+    ThrowingStruct::destruct_count = 0;
+    ArenaV2 arena(1024);
+
+    EXPECT_THROW(arena.create_array<ThrowingStruct>(10), std::runtime_error);
+    EXPECT_EQ(ThrowingStruct::destruct_count, 3);
+
+    arena.clear();
+    EXPECT_EQ(ThrowingStruct::destruct_count, 3);
+}
+
+TEST(ArenaTest, TestRewindDestroysArrays) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(1024);
+
+    arena.create_array<TestStruct>(5, 1, 1);
+    const ArenaV2::Marker marker = arena.mark();
+    arena.create_array<TestStruct>(20, 2, 2);
+
+    arena.rewind(marker);
+    EXPECT_EQ(TestStruct::destruct_count, 20);
+
+    arena.clear();
+    EXPECT_EQ(TestStruct::destruct_count, 25);
+}
+
+struct OrderedStruct {
+    int id;
+    static std::vector<int> destroyed;
+
+    explicit OrderedStruct(const int id) : id(id) {}
+    ~OrderedStruct() { destroyed.push_back(id); }
+};
+
+std::vector<int> OrderedStruct::destroyed;
+
+TEST(ArenaTest, TestCoalescedRunsDestroyInReverseOrder) {
+    OrderedStruct::destroyed.clear();
+    TestStruct::destruct_count = 0;
+    {
+        ArenaV2 arena(4096);
+        arena.create<OrderedStruct>(0);
+        arena.create<OrderedStruct>(1);
+        arena.create<TestStruct>(0, 0);
+        arena.create<OrderedStruct>(2);
+        arena.create_array<OrderedStruct>(2, 3);
+        arena.create<OrderedStruct>(4);
+
+        const ArenaV2::Marker marker = arena.mark();
+        arena.create<OrderedStruct>(5);
+        arena.create<OrderedStruct>(6);
+        arena.rewind(marker);
+
+        EXPECT_EQ(OrderedStruct::destroyed, (std::vector<int>{6, 5}));
+    }
+    EXPECT_EQ(OrderedStruct::destroyed, (std::vector<int>{6, 5, 4, 3, 3, 2, 1, 0}));
+    EXPECT_EQ(TestStruct::destruct_count, 1);
+}
+
+TEST(ArenaTest, TestCoalescedRunsUseOneRecord) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(16384);
+
+    for (int i = 0; i < 1000; ++i) {
+        arena.create<TestStruct>(i, i);
+    }
+
+    // without coalescing, 1000 records would need 32 destructor chunks and spill into a second block.
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+
+    arena.clear();
+    EXPECT_EQ(TestStruct::destruct_count, 1000);
+}
+
+struct CountingBlockSource : BlockSource {
+    int n_allocated = 0;
+    int n_deallocated = 0;
+
+    CountingBlockSource() noexcept : BlockSource{&counting_allocate, &counting_deallocate} {}
+
+    static void* counting_allocate(BlockSource* self, size_t& size) noexcept {
+        static_cast<CountingBlockSource*>(self)->n_allocated++;
+        return ::operator new(size, std::nothrow);
+    }
+
+    static void counting_deallocate(BlockSource* self, void* ptr, size_t) noexcept {
+        static_cast<CountingBlockSource*>(self)->n_deallocated++;
+        ::operator delete(ptr);
+    }
+};
+
+TEST(ArenaTest, TestCustomBlockSource) {
+    CountingBlockSource source;
+    {
+        ArenaV2 arena(ArenaOptions{.block_size = 64, .source = &source});
+        for (int i = 0; i < 100; ++i) {
+            arena.create<int>(i);
+        }
+        EXPECT_EQ(source.n_allocated, static_cast<int>(arena.get_number_of_allocated_blocks()));
+
+        ArenaV2 moved(std::move(arena));
+        EXPECT_EQ(source.n_deallocated, 0);
+    }
+    EXPECT_EQ(source.n_deallocated, source.n_allocated);
+}
+
+TEST(ArenaTest, TestMmapBlockSource) {
+    MmapBlockSource source;
+    ArenaV2 arena(ArenaOptions{.block_size = 1000, .source = &source});
+
+    // block sizes are rounded up to whole pages.
+    EXPECT_EQ(arena.get_arena_size() % static_cast<size_t>(::sysconf(_SC_PAGESIZE)), 0);
+
+    for (int i = 0; i < 10000; ++i) {
+        int* p = arena.create<int>(i);
+        EXPECT_EQ(*p, i);
+    }
+}
+
+TEST(ArenaTest, TestMmapBlockSourceHugePages) {
+    MmapBlockSource source({.huge_pages = true, .populate = true});
+    ArenaV2 arena(ArenaOptions{.block_size = 1 << 20, .source = &source});
+
+    EXPECT_EQ(arena.get_arena_size(), HUGE_PAGE_SIZE);
+
+    auto* arr = static_cast<char*>(arena.allocate_raw(1 << 20, 64));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arr) % HUGE_PAGE_SIZE, 0);
+    arr[(1 << 20) - 1] = 'x';
+    EXPECT_EQ(arr[(1 << 20) - 1], 'x');
+}
+
+TEST(ArenaTest, TestReservedBlockSourceGrowsInPlace) {
+    ReservedBlockSource source({.reserve_size = 1 << 30});
+    ArenaV2 arena(ArenaOptions{.block_size = 4096, .source = &source});
+
+    auto* first = static_cast<char*>(arena.allocate_raw(1024, 8));
+    char* last = first;
+    for (int i = 1; i < 1000; ++i) {
+        last = static_cast<char*>(arena.allocate_raw(1024, 8));
+    }
+
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(last - first, 999 * 1024);
+    EXPECT_GE(arena.get_arena_size(), 1000 * 1024);
+    last[1023] = 'x';
+    EXPECT_EQ(last[1023], 'x');
+}
+
+TEST(ArenaTest, TestReservedBlockSourceSpillsWhenReservationExhausted) {
+    ReservedBlockSource source({.reserve_size = 1 << 16});
+    ArenaV2 arena(ArenaOptions{.block_size = 4096, .source = &source});
+
+    for (int i = 0; i < 200; ++i) {
+        arena.allocate_raw(1024, 8);
+    }
+
+    EXPECT_GT(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(arena.get_arena_size() % 4096, 0);
+}
+
+TEST(ArenaTest, TestReservedBlockSourceReleasesPagesPastWatermark) {
+    const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    ReservedBlockSource source({.reserve_size = 1 << 30, .retain_bytes = page_size});
+    ArenaV2 arena(ArenaOptions{.block_size = 1 << 20, .source = &source});
+
+    auto* buffer = static_cast<char*>(arena.allocate_raw(1 << 20, 8));
+    std::memset(buffer, 0xab, 1 << 20);
+    arena.clear();
+
+    EXPECT_EQ(arena.allocate_raw(1 << 20, 8), buffer);
+    EXPECT_EQ(static_cast<unsigned char>(buffer[0]), 0xab);
+    EXPECT_EQ(buffer[page_size], 0);
+    EXPECT_EQ(buffer[(1 << 20) - 1], 0);
+}
+
+TEST(NumaArenaTest, TestNodeDiscovery) {
+    EXPECT_GE(numa_node_count(), 1);
+    EXPECT_GE(numa_current_node(), 0);
+    EXPECT_LT(numa_current_node(), numa_node_count());
+}
+
+TEST(NumaArenaTest, TestNumaBlockSource) {
+    NumaBlockSource source({.node = NUMA_NODE_OF_CALLER});
+    ArenaV2 arena(ArenaOptions{.block_size = 1 << 16, .source = &source});
+
+    for (int i = 0; i < 100000; ++i) {
+        int* p = arena.create<int>(i);
+        EXPECT_EQ(*p, i);
+    }
+}
+
+TEST(NumaArenaTest, TestPoolReusesReleasedArenas) {
+    NumaArenaPool pool(ArenaOptions{.block_size = 4096});
+    const int node = numa_current_node();
+
+    ArenaV2 arena = pool.acquire(node);
+    for (int i = 0; i < 10000; ++i) {
+        arena.create<int>(i);
+    }
+    const size_t n_blocks = arena.get_number_of_allocated_blocks();
+
+    EXPECT_TRUE(pool.release(std::move(arena)));
+    EXPECT_EQ(pool.get_number_of_free_arenas(node), 1);
+    EXPECT_EQ(pool.get_number_of_free_arenas(-1), pool.get_number_of_free_arenas(0));
+    EXPECT_EQ(pool.get_number_of_free_arenas(1 << 20), pool.get_number_of_free_arenas(0));
+
+    ArenaV2 reused = pool.acquire(node);
+    EXPECT_EQ(reused.get_number_of_allocated_blocks(), n_blocks);
+    EXPECT_EQ(pool.get_number_of_free_arenas(node), 0);
+
+    std::vector<int, ArenaAllocator<int>> vec{ArenaAllocator<int>(reused)};
+    for (int i = 0; i < 1000; ++i) vec.push_back(i);
+    EXPECT_EQ(vec[999], 999);
+    EXPECT_EQ(reused.get_number_of_allocated_blocks(), n_blocks);
+}
+
+TEST(NumaArenaTest, TestPoolRefusesForeignArenas) {
+    NumaArenaPool pool(ArenaOptions{.block_size = 4096});
+    ArenaV2 foreign(4096);
+    int* value = foreign.create<int>(42);
+
+    EXPECT_FALSE(pool.release(std::move(foreign)));
+    EXPECT_EQ(*value, 42);
+    EXPECT_EQ(foreign.get_number_of_allocated_blocks(), 1);
+}
+
+TEST(BlockCacheTest, TestArenaReusesCachedBlocks) {
+    BlockCache::trim(0);
+    const BlockCache::ThreadStats before = BlockCache::get_thread_stats();
+
+    for (int iter = 0; iter < 100; ++iter) {
+        ArenaV2 arena(ArenaOptions{.block_size = 8192, .source = BlockCache::instance()});
+        for (int i = 0; i < 4096; ++i) {
+            arena.create<int>(i);
+        }
+    }
+
+    const BlockCache::ThreadStats after = BlockCache::get_thread_stats();
+    EXPECT_EQ(after.misses - before.misses, 2);
+    EXPECT_EQ(after.hits - before.hits, 198);
+    EXPECT_EQ(after.cached_bytes, 2 * 8192);
+
+    BlockCache::trim(0);
+    EXPECT_EQ(BlockCache::get_thread_stats().cached_bytes, 0);
+}
+
+TEST(BlockCacheTest, TestBlockSizesRoundedToClass) {
+    ArenaV2 arena(ArenaOptions{.block_size = 3000, .source = BlockCache::instance()});
+    EXPECT_EQ(arena.get_arena_size(), 4096);
+}
+
+TEST(BlockCacheTest, TestHighWaterMark) {
+    BlockCache::trim(0);
+    BlockCache::set_high_water_mark(16 * 1024);
+
+    {
+        ArenaV2 arena(ArenaOptions{.block_size = 8192, .source = BlockCache::instance()});
+        for (int i = 0; i < 100000; ++i) {
+            arena.create<int>(i);
+        }
+    }
+    EXPECT_EQ(BlockCache::get_thread_stats().cached_bytes, 16 * 1024);
+
+    BlockCache::set_high_water_mark(DEFAULT_BLOCK_CACHE_HIGH_WATER_MARK);
+    BlockCache::trim(8192);
+    EXPECT_EQ(BlockCache::get_thread_stats().cached_bytes, 8192);
+    BlockCache::trim(0);
+}
+
+TEST(BlockCacheTest, TestCacheReleasedAtThreadExit) {
+    std::thread worker([] {
+        ArenaV2 arena(ArenaOptions{.block_size = 8192, .source = BlockCache::instance()});
+        arena.create<int>(1);
+    });
+    worker.join();
+
+    // the worker's cached block is released by its reaper, leak checkers catch a regression here.
+    EXPECT_EQ(BlockCache::get_thread_stats().cached_bytes, 0);
+}
+
+TEST(InlineArenaTest, TestNoHeapAllocationUntilSpill) {
+    CountingBlockSource source;
+    InlineArenaV2<256> arena(ArenaOptions{.block_size = 1024, .source = &source});
+
+    for (int i = 0; i < 32; ++i) {
+        int* p = arena.create<int>(i);
+        EXPECT_EQ(*p, i);
+    }
+    EXPECT_EQ(source.n_allocated, 0);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(arena.get_arena_size(), 256);
+
+    for (int i = 0; i < 1000; ++i) {
+        arena.create<int>(i);
+    }
+    EXPECT_GT(source.n_allocated, 0);
+}
+
+TEST(InlineArenaTest, TestSpillsBeyondInlineBlockSlots) {
+    TestStruct::destruct_count = 0;
+    {
+        StackArena<64> arena(ArenaOptions{.block_size = 64});
+        for (int i = 0; i < 1000; ++i) {
+            arena.create<TestStruct>(i, i);
+        }
+        EXPECT_GT(arena.get_number_of_allocated_blocks(), INLINE_ARENA_BLOCK_SLOTS);
+
+        arena.clear();
+        EXPECT_EQ(TestStruct::destruct_count, 1000);
+        for (int i = 0; i < 10; ++i) {
+            arena.create<TestStruct>(i, i);
+        }
+    }
+    EXPECT_EQ(TestStruct::destruct_count, 1010);
+}
+
+TEST(InlineArenaTest, TestArenaAllocator) {
+    InlineArenaV2<512> arena;
+    std::vector<int, ArenaAllocator<int>> vec{ArenaAllocator<int>(arena)};
+
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+    }
+    EXPECT_EQ(vec[999], 999);
+}
+
+TEST(ArenaTest, TestDeallocateRawRollsBackLatestAllocation) {
+    ArenaV2 arena(1024);
+
+    void* a = arena.allocate_raw(64, 8);
+    void* b = arena.allocate_raw(64, 8);
+
+    EXPECT_FALSE(arena.deallocate_raw(a, 64));
+    EXPECT_TRUE(arena.deallocate_raw(b, 64));
+    EXPECT_EQ(arena.allocate_raw(64, 8), b);
+}
+
+TEST(ArenaTest, TestTryExtendAndReallocate) {
+    ArenaV2 arena(1024);
+
+    auto* a = static_cast<int*>(arena.allocate_raw(16, alignof(int)));
+    a[0] = 42;
+    EXPECT_TRUE(arena.try_extend(a, 16, 512));
+    EXPECT_FALSE(arena.try_extend(a, 512, 4096));
+
+    arena.allocate_raw(8, 8);
+    EXPECT_FALSE(arena.try_extend(a, 512, 600));
+
+    auto* moved = static_cast<int*>(arena.reallocate(a, 512, 600, alignof(int)));
+    EXPECT_NE(moved, a);
+    EXPECT_EQ(moved[0], 42);
+    EXPECT_EQ(arena.reallocate(moved, 600, 700, alignof(int)), moved);
+}
+
+TEST(ArenaTest, TestEpochRefusesStalePointers) {
+    ArenaV2 arena(1024);
+
+    arena.allocate_raw(8, 8);
+    void* stale = arena.allocate_raw(64, 8);
+    const uint64_t stale_epoch = arena.get_epoch();
+    arena.clear();
+    EXPECT_NE(arena.get_epoch(), stale_epoch);
+
+    // the new cycle's bump pointer ends where the stale allocation does.
+    char* live = static_cast<char*>(arena.allocate_raw(8 + 64, 8));
+    ASSERT_EQ(live + 8, stale);
+    EXPECT_FALSE(arena.try_extend(stale, 64, 128, stale_epoch));
+    EXPECT_FALSE(arena.deallocate_raw(stale, 64, stale_epoch));
+    EXPECT_EQ(arena.allocate_raw(8, 8), live + 8 + 64);
+
+    void* fresh = arena.allocate_raw(32, 8);
+    EXPECT_TRUE(arena.try_extend(fresh, 32, 48, arena.get_epoch()));
+    EXPECT_TRUE(arena.deallocate_raw(fresh, 48, arena.get_epoch()));
+
+    const ArenaV2::Marker marker = arena.mark();
+    const uint64_t before_rewind = arena.get_epoch();
+    arena.rewind(marker);
+    EXPECT_NE(arena.get_epoch(), before_rewind);
+}
+
+TEST(ArenaTest, TestArenaAllocatorDeallocateAfterClearKeepsLiveAllocations) {
+    ArenaV2 arena(1024);
+    ArenaAllocator<int> alloc(arena);
+
+    arena.allocate_raw(8, 8);
+    int* stale = alloc.allocate(16);
+    arena.clear();
+
+    // the new cycle's bump pointer ends where the stale buffer does.
+    char* live = static_cast<char*>(arena.allocate_raw(8 + 16 * sizeof(int), 8));
+    ASSERT_EQ(reinterpret_cast<int*>(live + 8), stale);
+    alloc.deallocate(stale, 16);
+    EXPECT_NE(arena.allocate_raw(8, 8), stale);
+}
+
+struct SkipDestroyStruct {
+    static int destruct_count;
+    ~SkipDestroyStruct() { destruct_count++; }
+};
+
+int SkipDestroyStruct::destruct_count = 0;
+
+template<>
+struct arena_skip_destroy<SkipDestroyStruct> : std::true_type {};
+
+TEST(ArenaTest, TestSkipDestroyTraitAndCreateNoDtor) {
+    TestStruct::destruct_count = 0;
+    SkipDestroyStruct::destruct_count = 0;
+    {
+        ArenaV2 arena(1024);
+        arena.create<SkipDestroyStruct>();
+        arena.create_array<SkipDestroyStruct>(8);
+        arena.create_no_dtor<TestStruct>(1, 2);
+        arena.create<TestStruct>(3, 4);
+    }
+    EXPECT_EQ(SkipDestroyStruct::destruct_count, 0);
+    EXPECT_EQ(TestStruct::destruct_count, 1);
+}
+
+TEST(ArenaTest, TestLeakDestructorsMode) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(ArenaOptions{.block_size = 1024, .leak_destructors = true});
+    EXPECT_TRUE(arena.get_leak_destructors());
+
+    void* first = arena.create<TestStruct>(1, 2);
+    for (int i = 0; i < 100; ++i) {
+        arena.create<TestStruct>(i, i);
+    }
+
+    // no destructor chunks are allocated, objects are packed back to back.
+    EXPECT_EQ(arena.get_arena_size(), 1024 * ((101 * sizeof(TestStruct) + 1023) / 1024));
+
+    arena.clear();
+    EXPECT_EQ(TestStruct::destruct_count, 0);
+    EXPECT_EQ(arena.create<TestStruct>(5, 6), first);
+}
+
+TEST(ArenaTest, TestClearParallel) {
+    ConcurrentTestStruct::destruct_count = 0;
+    ArenaV2 arena(1 << 16, ArenaGrowthPolicy::geometric(2.0, 1 << 22));
+
+    constexpr int n = 100000;
+    for (int i = 0; i < n; ++i) {
+        arena.create<ConcurrentTestStruct>(i);
+        if (i % 1000 == 0) arena.create<std::string>("breaks the run of ConcurrentTestStruct");
+    }
+    arena.create_array<ConcurrentTestStruct>(1000, 7);
+
+    arena.clear_parallel(4);
+    EXPECT_EQ(ConcurrentTestStruct::destruct_count, n + 1000);
+
+    // small arenas fall back to a plain clear.
+    arena.create<ConcurrentTestStruct>(1);
+    arena.clear_parallel(4);
+    EXPECT_EQ(ConcurrentTestStruct::destruct_count, n + 1001);
+}
+
+TEST(ArenaTest, TestClearAsyncHandsOffUsedBlocks) {
+    CountingBlockSource source;
+    TestStruct::destruct_count = 0;
+
+    ArenaV2 arena(ArenaOptions{.block_size = 4096, .source = &source});
+    for (int i = 0; i < 1000; ++i) {
+        arena.create<TestStruct>(i, i);
+    }
+    const int n_used = source.n_allocated;
+    EXPECT_GT(n_used, 1);
+
+    std::future<void> reclaimed = arena.clear_async();
+    auto* obj = arena.create<TestStruct>(1, 2);
+    EXPECT_EQ(obj->x, 1);
+
+    reclaimed.get();
+    EXPECT_EQ(TestStruct::destruct_count, 1000);
+    EXPECT_EQ(source.n_deallocated, n_used);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(arena.get_arena_size(), 4096);
+}
+
+TEST(ArenaTest, TestClearAsyncInlineArenaIsSynchronous) {
+    TestStruct::destruct_count = 0;
+    InlineArenaV2<256> arena;
+    arena.create<TestStruct>(1, 2);
+
+    std::future<void> reclaimed = arena.clear_async();
+    EXPECT_EQ(TestStruct::destruct_count, 1);
+    reclaimed.get();
+}
+
+TEST(ArenaTest, TestClearAsyncChildArenaIsSynchronous) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 parent(4096);
+    const size_t parent_blocks = parent.get_number_of_allocated_blocks();
+    {
+        ChildArenaV2 child = parent.make_child(256);
+        for (int i = 0; i < 100; ++i) {
+            child.create<TestStruct>(i, i);
+        }
+        EXPECT_GT(child.get_number_of_allocated_blocks(), 1);
+
+        // the child's blocks belong to the parent, so nothing is left for another thread.
+        std::future<void> reclaimed = child.clear_async();
+        EXPECT_EQ(TestStruct::destruct_count, 100);
+
+        for (int i = 0; i < 100; ++i) {
+            std::memset(parent.allocate_raw(64, 8), 0xab, 64);
+            child.create<TestStruct>(i, i);
+        }
+        reclaimed.get();
+    }
+
+    EXPECT_EQ(TestStruct::destruct_count, 200);
+    EXPECT_GT(parent.get_number_of_allocated_blocks(), parent_blocks);
+}
+
+TEST(ArenaTest, TestStats) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(256);
+
+    arena.allocate_raw(1, 1);
+    arena.allocate_raw(8, 8);
+    arena.create<TestStruct>(1, 2);
+
+    ArenaStats stats = arena.get_stats();
+    if constexpr (!ArenaStats::enabled) {
+        EXPECT_EQ(stats.n_allocations, 0);
+        EXPECT_EQ(stats.peak_bytes_in_use, 0);
+        return;
+    }
+
+    // the destructor chunk does not fit the first block and takes the slow path.
+    constexpr size_t chunk_bytes = 1040;
+    EXPECT_EQ(stats.n_allocations, 4);
+    EXPECT_EQ(stats.bytes_requested, 1 + 8 + sizeof(TestStruct) + chunk_bytes);
+    EXPECT_EQ(stats.padding_bytes, 7);
+    EXPECT_EQ(stats.bytes_consumed, stats.bytes_requested + 7);
+    EXPECT_EQ(stats.n_slow_path, 1);
+    EXPECT_EQ(stats.tail_waste_bytes, 256 - 24);
+    EXPECT_EQ(stats.n_destructor_registrations, 1);
+    EXPECT_EQ(stats.destructor_chunk_bytes, chunk_bytes);
+    EXPECT_EQ(stats.bytes_in_use, 24 + chunk_bytes);
+    EXPECT_EQ(stats.bytes_reserved, arena.get_arena_size());
+
+    // growing in place counts the extra bytes as requested.
+    void* grown = arena.allocate_raw(16, 8);
+    ASSERT_TRUE(arena.try_extend(grown, 16, 48));
+    EXPECT_EQ(arena.get_stats().bytes_requested, stats.bytes_requested + 48);
+    ASSERT_TRUE(arena.deallocate_raw(grown, 48));
+
+    arena.clear();
+    stats = arena.get_stats();
+    EXPECT_EQ(stats.bytes_in_use, 0);
+    EXPECT_EQ(stats.peak_bytes_in_use, 24 + chunk_bytes + 48);
+
+    arena.reset_stats();
+    EXPECT_EQ(arena.get_stats().n_allocations, 0);
+    EXPECT_EQ(arena.get_stats().peak_bytes_in_use, 0);
+}
+
+TEST(ArenaTest, TestDebugRedzoneDetectsOverflow) {
+    if constexpr (!ARENA_DEBUG) return;
+
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_DEATH({
+        ArenaV2 arena(ArenaOptions{.block_size = 256, .debug_redzone = 16});
+        char* p = static_cast<char*>(arena.allocate_raw(10, 8));
+        p[10] = 'x';
+        arena.clear();
+    }, "redzone|use-after-poison");
+}
+
+TEST(ArenaTest, TestDebugRedzoneDetectsInlineArenaOverflow) {
+    if constexpr (!ARENA_DEBUG) return;
+
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_DEATH({
+        InlineArenaV2<256> arena(ArenaOptions{.debug_redzone = 16});
+        char* p = static_cast<char*>(arena.allocate_raw(10, 8));
+        p[10] = 'x';
+        arena.clear();
+    }, "redzone|use-after-poison");
+}
+
+TEST(ArenaTest, TestDebugRedzonesKeepLatestAllocationResizable) {
+    const size_t redzone = ARENA_DEBUG ? 16 : 0;
+    ArenaV2 arena(ArenaOptions{.block_size = 1024, .debug_redzone = 16});
+
+    char* p = static_cast<char*>(arena.allocate_raw(32, 8));
+    ASSERT_TRUE(arena.try_extend(p, 32, 64));
+    std::memset(p, 0xab, 64);
+
+    char* q = static_cast<char*>(arena.allocate_raw(8, 8));
+    EXPECT_EQ(q, p + 64 + redzone);
+    EXPECT_FALSE(arena.try_extend(p, 64, 128));
+
+    EXPECT_TRUE(arena.deallocate_raw(q, 8));
+    EXPECT_TRUE(arena.deallocate_raw(p, 64));
+    EXPECT_EQ(arena.allocate_raw(32, 8), p);
+
+    const ArenaV2::Marker marker = arena.mark();
+    std::memset(arena.allocate_raw(100, 8), 0xab, 100);
+    arena.rewind(marker);
+    arena.clear();
+}
+
+#if ARENA_DEBUG && defined(ARENA_ASAN)
+TEST(ArenaTest, TestDebugPoisonsReleasedMemory) {
+    ArenaV2 arena(1024);
+
+    char* p = static_cast<char*>(arena.allocate_raw(64, 8));
+    EXPECT_FALSE(__asan_region_is_poisoned(p, 64));
+    EXPECT_TRUE(__asan_address_is_poisoned(p + 64));
+
+    const ArenaV2::Marker marker = arena.mark();
+    char* q = static_cast<char*>(arena.allocate_raw(64, 8));
+    EXPECT_FALSE(__asan_region_is_poisoned(q, 64));
+    arena.rewind(marker);
+    EXPECT_TRUE(__asan_address_is_poisoned(q));
+    EXPECT_FALSE(__asan_region_is_poisoned(p, 64));
+
+    arena.clear();
+    EXPECT_TRUE(__asan_address_is_poisoned(p));
+}
+#endif
+
+static void fill_arena(ArenaV2& arena, const size_t bytes) {
+    for (size_t i = 0; i < bytes / 64; ++i) {
+        arena.allocate_raw(64, 8);
+    }
+}
+
+TEST(ArenaTest, TestAdaptiveSizingCoalescesBlocks) {
+    ArenaV2 arena(ArenaOptions{.block_size = 1024, .adaptive = {.enabled = true}});
+
+    fill_arena(arena, 16384);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 16);
+
+    arena.clear();
+    EXPECT_EQ(arena.get_high_water_mark(), 16384);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(arena.get_arena_size(), 16384 * 5 / 4);
+
+    const size_t slow_path = arena.get_stats().n_slow_path;
+    fill_arena(arena, 16384);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(arena.get_stats().n_slow_path, slow_path);
+
+    // the same block is kept while usage stays within it.
+    arena.clear();
+    EXPECT_EQ(arena.get_arena_size(), 16384 * 5 / 4);
+}
+
+TEST(ArenaTest, TestAdaptiveSizingDecaysAfterSpike) {
+    ArenaV2 arena(ArenaOptions{.block_size = 1024, .adaptive = {.enabled = true, .decay = 0.5}});
+
+    fill_arena(arena, 1 << 20);
+    arena.clear();
+    EXPECT_GE(arena.get_arena_size(), size_t{1} << 20);
+
+    for (int i = 0; i < 16; ++i) {
+        fill_arena(arena, 4096);
+        arena.clear();
+    }
+
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_LT(arena.get_arena_size(), 16384);
+    EXPECT_GE(arena.get_arena_size(), 4096);
+}
+
+TEST(ArenaTest, TestAdaptiveSizingKeepsInlineBlock) {
+    InlineArenaV2<1024> arena(ArenaOptions{.block_size = 1024, .adaptive = {.enabled = true}});
+
+    fill_arena(arena, 8192);
+    arena.clear();
+
+    // the inline block plus one spilled block covering the rest of the target.
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 2);
+    EXPECT_EQ(arena.get_arena_size(), 8192 * 5 / 4);
+
+    fill_arena(arena, 8192);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 2);
+}
+
+TEST(ArenaTest, TestTypedAllocateMixedAlignment) {
+    ArenaV2 arena(4096);
+
+    char* c = arena.allocate<char>();
+    double* d = arena.allocate<double>(3);
+    char* c2 = arena.allocate<char>(5);
+    auto* v = arena.allocate<std::max_align_t>();
+
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(v) % alignof(std::max_align_t), 0);
+    EXPECT_EQ(c2, reinterpret_cast<char*>(d + 3));
+    EXPECT_LT(reinterpret_cast<char*>(d) - c, static_cast<ptrdiff_t>(alignof(double)) + 1);
+
+    EXPECT_EQ(arena.allocate<int>(0), nullptr);
+    EXPECT_THROW((void) arena.allocate<double>(std::numeric_limits<size_t>::max() / 4), std::bad_array_new_length);
+
+    // the bump pointer survives moving to another block and back through mark and rewind.
+    const ArenaV2::Marker marker = arena.mark();
+    for (int i = 0; i < 100; ++i) {
+        double* x = arena.allocate<double>(16);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(x) % alignof(double), 0);
+    }
+    arena.rewind(marker);
+    EXPECT_EQ(arena.allocate<char>(), reinterpret_cast<char*>(v + 1));
+}
+
+TEST(ArenaVectorTest, TestGrowsInPlace) {
+    ArenaV2 arena(1 << 16);
+    ArenaVector<int> vec(arena);
+
+    vec.push_back(0);
+    int* data = vec.data();
+    for (int i = 1; i < 4096; ++i) {
+        vec.push_back(i);
+    }
+
+    EXPECT_EQ(vec.data(), data);
+    EXPECT_EQ(vec.size(), 4096);
+    for (int i = 0; i < 4096; ++i) {
+        EXPECT_EQ(vec[i], i);
+    }
+}
+
+TEST(ArenaVectorTest, TestRelocatesWhenNotLatest) {
+    ArenaV2 arena(1 << 16);
+    ArenaVector<std::string> vec(arena);
+
+    for (int i = 0; i < 4; ++i) {
+        vec.push_back(std::to_string(i));
+    }
+    const std::string* data = vec.data();
+    arena.allocate_raw(8, 8);
+
+    vec.emplace_back("4");
+    EXPECT_NE(vec.data(), data);
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(vec[i], std::to_string(i));
+    }
+}
+
+TEST(ArenaVectorTest, TestPushesOwnElementAtCapacity) {
+    ArenaV2 arena(1 << 16);
+    ArenaVector<std::string> vec(arena);
+
+    for (int i = 0; i < 4; ++i) {
+        vec.push_back(std::string(32, static_cast<char>('a' + i)));
+    }
+    arena.allocate_raw(8, 8);
+
+    // the buffer relocates while the argument still refers to its old storage.
+    ASSERT_EQ(vec.size(), vec.capacity());
+    vec.push_back(vec[0]);
+    vec.emplace_back(vec.back());
+    EXPECT_EQ(vec.size(), 6);
+    EXPECT_EQ(vec[4], std::string(32, 'a'));
+    EXPECT_EQ(vec[5], std::string(32, 'a'));
+    EXPECT_EQ(vec[3], std::string(32, 'd'));
+}
+
+TEST(ArenaVectorTest, TestDestroysElementsAndReclaimsBuffer) {
+    TestStruct::destruct_count = 0;
+    ArenaV2 arena(1 << 12);
+
+    void* before = arena.allocate_raw(8, 8);
+    arena.deallocate_raw(before, 8);
+    {
+        ArenaVector<TestStruct> vec(arena);
+        for (int i = 0; i < 100; ++i) {
+            vec.emplace_back(i, i);
+        }
+    }
+    EXPECT_EQ(TestStruct::destruct_count, 100);
+    EXPECT_EQ(arena.allocate_raw(8, 8), before);
+}
+
+TEST(ArenaVectorTest, TestOutlivingClearKeepsLiveAllocations) {
+    ArenaV2 arena(1024);
+    arena.allocate_raw(8, 8);
+    char* live = nullptr;
+    {
+        ArenaVector<int> vec(arena);
+        vec.reserve(16);
+        arena.clear();
+
+        // the new cycle's bump pointer ends where the stale buffer does.
+        live = static_cast<char*>(arena.allocate_raw(8 + 16 * sizeof(int), 8));
+        ASSERT_EQ(reinterpret_cast<int*>(live + 8), vec.data());
+    }
+    EXPECT_EQ(arena.allocate_raw(8, 8), live + 8 + 16 * sizeof(int));
+}
+
+struct ThrowingCopy {
+    static int n_live;
+    static int copies_left;
+    int value;
+
+    explicit ThrowingCopy(const int value) : value(value) {n_live++;}
+    ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+        if (copies_left-- == 0) throw std::runtime_error("copy");
+        n_live++;
+    }
+    ~ThrowingCopy() {n_live--;}
+};
+
+int ThrowingCopy::n_live = 0;
+int ThrowingCopy::copies_left = 0;
+
+TEST(ArenaVectorTest, TestThrowingRelocationLeavesVectorUnchanged) {
+    ArenaV2 arena(1 << 16);
+    {
+        ArenaVector<ThrowingCopy> vec(arena);
+        for (int i = 0; i < 4; ++i) {
+            vec.emplace_back(i);
+        }
+        arena.allocate_raw(8, 8);
+
+        // relocation copies, the move constructor is not noexcept, and the third copy throws.
+        ThrowingCopy::copies_left = 2;
+        EXPECT_THROW(vec.emplace_back(4), std::runtime_error);
+        EXPECT_EQ(ThrowingCopy::n_live, 4);
+        ASSERT_EQ(vec.size(), 4);
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(vec[i].value, i);
+        }
+
+        ThrowingCopy::copies_left = 2;
+        EXPECT_THROW(vec.reserve(64), std::runtime_error);
+        EXPECT_EQ(ThrowingCopy::n_live, 4);
+        EXPECT_EQ(vec.capacity(), 4);
+    }
+    EXPECT_EQ(ThrowingCopy::n_live, 0);
+}
+
+TEST(PoolArenaTest, TestReusesFreedChunks) {
+    PoolArena pool(4096);
+
+    void* a = pool.allocate_raw(24, 8);
+    pool.deallocate_raw(a, 24);
+    EXPECT_EQ(pool.get_free_bytes(), 32);
+
+    // same size class, so the freed chunk is reused.
+    EXPECT_EQ(pool.allocate_raw(30, 8), a);
+    EXPECT_EQ(pool.get_free_bytes(), 0);
+}
+
+TEST(PoolArenaTest, TestLargeFreeAfterClearKeepsLiveAllocations) {
+    PoolArena pool(4096);
+    constexpr size_t large = 2 * POOL_ARENA_MAX_CHUNK_SIZE;
+
+    pool.get_arena().allocate_raw(16, 16);
+    void* stale = pool.allocate_raw(large, 16);
+    pool.clear();
+
+    // the new cycle's bump pointer ends where the stale chunk does.
+    char* live = static_cast<char*>(pool.allocate_raw(16 + large, 16));
+    ASSERT_EQ(live + 16, stale);
+    pool.deallocate_raw(stale, large);
+    EXPECT_EQ(pool.allocate_raw(large, 16), live + 16 + large);
+}
+
+TEST(PoolArenaTest, TestOverAlignedChunksRecycled) {
+    PoolArena pool(4096);
+
+    void* a = pool.allocate_raw(40, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) & 63, 0);
+    pool.deallocate_raw(a, 40);
+
+    EXPECT_EQ(pool.allocate_raw(48, 16), a);
+}
+
+TEST(PoolArenaTest, TestMapChurnDoesNotGrowArena) {
+    PoolArena pool(65536);
+    std::map<int, int, std::less<int>, PoolArenaAllocator<std::pair<const int, int>>> map{
+        std::less<int>(), PoolArenaAllocator<std::pair<const int, int>>(pool)};
+
+    for (int i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    const size_t arena_size = pool.get_arena().get_arena_size();
+
+    for (int i = 1000; i < 100000; ++i) {
+        map.erase(i - 1000);
+        map[i] = i;
+    }
+
+    EXPECT_EQ(map.size(), 1000);
+    EXPECT_EQ(map.begin()->first, 99000);
+    EXPECT_EQ(pool.get_arena().get_arena_size(), arena_size);
+}
+
+TEST(PoolArenaTest, TestListChurnDoesNotGrowArena) {
+    PoolArena pool(4096);
+    std::list<std::string, PoolArenaAllocator<std::string>> lst{PoolArenaAllocator<std::string>(pool)};
+
+    for (int i = 0; i < 100; ++i) {
+        lst.emplace_back(std::to_string(i));
+    }
+    const size_t arena_size = pool.get_arena().get_arena_size();
+
+    for (int i = 0; i < 10000; ++i) {
+        lst.pop_front();
+        lst.emplace_back(std::to_string(i));
+    }
+
+    EXPECT_EQ(lst.size(), 100);
+    EXPECT_EQ(lst.back(), "9999");
+    EXPECT_EQ(pool.get_arena().get_arena_size(), arena_size);
+}
+
+TEST(ArenaMemoryResourceTest, TestPmrContainers) {
+    ArenaV2 arena(1 << 16);
+    ArenaMemoryResource resource(arena);
+
+    std::pmr::vector<int> vec(&resource);
+    std::pmr::map<int, std::pmr::string> map(&resource);
+
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i);
+        map.emplace(i, std::to_string(i) + " long enough to leave the small string buffer");
+    }
+
+    EXPECT_EQ(vec[999], 999);
+    EXPECT_EQ(map.at(500), "500 long enough to leave the small string buffer");
+    EXPECT_EQ(map.at(500).get_allocator().resource(), &resource);
+    EXPECT_EQ(arena.get_number_of_allocated_blocks() > 1, true);
+}
+
+TEST(ArenaMemoryResourceTest, TestDeallocateAfterClearKeepsLiveAllocations) {
+    ArenaV2 arena(1024);
+    ArenaMemoryResource resource(arena);
+    char* live = nullptr;
+    {
+        arena.allocate_raw(8, 8);
+        std::pmr::vector<int> stale(&resource);
+        stale.reserve(16);
+        arena.clear();
+
+        // the new cycle's bump pointer ends where the stale buffer does.
+        live = static_cast<char*>(arena.allocate_raw(8 + 16 * sizeof(int), 8));
+        ASSERT_EQ(reinterpret_cast<int*>(live + 8), stale.data());
+    }
+    EXPECT_EQ(arena.allocate_raw(8, 8), live + 8 + 16 * sizeof(int));
+}
+
+TEST(ArenaMemoryResourceTest, TestAlignmentAndEquality) {
+    ArenaV2 arena(1024);
+    ArenaMemoryResource resource(arena);
+    ArenaMemoryResource other(arena);
+
+    void* p = resource.allocate(24, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) & 63, 0);
+
+    resource.deallocate(p, 24, 64);
+    EXPECT_NE(resource.allocate(24, 64), p);
+
+    EXPECT_TRUE(resource.is_equal(resource));
+    EXPECT_FALSE(resource.is_equal(other));
+}
+
+struct SnapshotNode {
+    int key;
+    arena_span<char> name;
+    arena_ptr<SnapshotNode> next;
+};
+
+struct alignas(64) SnapshotAligned {
+    int value;
+};
+
+struct SnapshotRoot {
+    arena_span<arena_ptr<SnapshotNode>> buckets;
+    arena_ptr<SnapshotAligned> aligned;
+};
+
+TEST(MappedArenaTest, TestSnapshotRoundTrip) {
+    ArenaV2 arena(256);
+
+    constexpr size_t n_buckets = 8;
+    auto* buckets = arena.create_array<arena_ptr<SnapshotNode>>(n_buckets);
+    for (int key = 0; key < 100; ++key) {
+        const std::string name = "node " + std::to_string(key);
+        char* chars = arena.create_array_uninitialized<char>(name.size());
+        std::memcpy(chars, name.data(), name.size());
+
+        arena_ptr<SnapshotNode>& head = buckets[key % n_buckets];
+        head = arena.to_arena_ptr(arena.create<SnapshotNode>(key, arena.to_arena_span(chars, name.size()), head));
+    }
+
+    auto* root = arena.create<SnapshotRoot>(arena.to_arena_span(buckets, n_buckets),
+                                            arena.to_arena_ptr(arena.create<SnapshotAligned>(42)));
+    EXPECT_GT(arena.get_number_of_allocated_blocks(), 1);
+    EXPECT_EQ(arena.resolve(root->aligned)->value, 42);
+
+    FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_TRUE(arena.snapshot(fileno(file), arena.to_arena_ptr(root)));
+
+    const MappedArena mapped(fileno(file));
+    std::fclose(file);
+
+    const SnapshotRoot* loaded = mapped.root<SnapshotRoot>();
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_NE(static_cast<const void*>(loaded), static_cast<const void*>(root));
+    EXPECT_EQ(mapped.get_number_of_blocks(), arena.get_number_of_allocated_blocks());
+
+    const SnapshotAligned* aligned = mapped.resolve(loaded->aligned);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) & 63, 0);
+    EXPECT_EQ(aligned->value, 42);
+
+    int n_nodes = 0;
+    for (const arena_ptr<SnapshotNode>& head : mapped.resolve(loaded->buckets)) {
+        for (const SnapshotNode* node = mapped.resolve(head); node; node = mapped.resolve(node->next), ++n_nodes) {
+            const std::span<const char> name = mapped.resolve(node->name);
+            EXPECT_EQ(std::string(name.begin(), name.end()), "node " + std::to_string(node->key));
+        }
+    }
+    EXPECT_EQ(n_nodes, 100);
+}
+
+TEST(MappedArenaTest, TestArenaPtrConversion) {
+    ArenaV2 arena(64);
+    int* first = arena.create<int>(1);
+    arena.allocate_raw(128, 8);
+    int* second = arena.create<int>(2);
+    int outside = 3;
+
+    const arena_ptr<int> p1 = arena.to_arena_ptr(first);
+    const arena_ptr<int> p2 = arena.to_arena_ptr(second);
+    EXPECT_EQ(p1.block_index(), 0);
+    EXPECT_NE(p2.block_index(), 0);
+    EXPECT_EQ(arena.resolve(p1), first);
+    EXPECT_EQ(arena.resolve(p2), second);
+    EXPECT_EQ(arena_ptr<int>::from_raw(p2.raw()), p2);
+
+    EXPECT_FALSE(arena.to_arena_ptr(&outside));
+    EXPECT_FALSE(arena.to_arena_ptr<int>(nullptr));
+    EXPECT_EQ(arena.resolve(arena_ptr<int>{}), nullptr);
+}
+
+TEST(MappedArenaTest, TestResolveRejectsOutOfRangeHandles) {
+    ArenaV2 arena(256);
+    int* value = arena.create<int>(7);
+    auto* values = arena.create_array<int>(4);
+
+    FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    ASSERT_TRUE(arena.snapshot(fileno(file), arena.to_arena_ptr(value)));
+    const MappedArena mapped(fileno(file));
+    std::fclose(file);
+
+    ASSERT_EQ(mapped.get_number_of_blocks(), 1);
+    EXPECT_EQ(*mapped.root<int>(), 7);
+
+    // handles as a corrupt file could hold them: past the block table, or past the end of the block.
+    EXPECT_EQ(mapped.resolve(arena_ptr<int>(1, 0)), nullptr);
+    EXPECT_EQ(mapped.resolve(arena_ptr<int>(0, 1 << 20)), nullptr);
+    EXPECT_EQ(mapped.resolve(arena_span<int>{arena.to_arena_ptr(values), 4}).size(), 4);
+    EXPECT_TRUE(mapped.resolve(arena_span<int>{arena.to_arena_ptr(values), 1 << 20}).empty());
+    EXPECT_TRUE(mapped.resolve(arena_span<int>{arena_ptr<int>(5, 0), 1}).empty());
+}
+
+TEST(MappedArenaTest, TestRejectsInvalidFile) {
+    FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    EXPECT_THROW(MappedArena{fileno(file)}, std::invalid_argument);
+
+    const char garbage[64]{};
+    std::fwrite(garbage, 1, sizeof(garbage), file);
+    std::fflush(file);
+    EXPECT_THROW(MappedArena{fileno(file)}, std::invalid_argument);
+    std::fclose(file);
+}
+
+TEST(ArenaStringTest, TestCopyString) {
+    ArenaV2 arena(64);
+    std::string source = "a string longer than one block of the arena";
+
+    const std::string_view copy = arena.copy_string(source);
+    source.assign(source.size(), 'x');
+
+    EXPECT_EQ(copy, "a string longer than one block of the arena");
+    EXPECT_EQ(copy.data()[copy.size()], '\0');
+    EXPECT_EQ(arena.copy_string(""), "");
+}
+
+TEST(ArenaStringTest, TestArenaString) {
+    ArenaV2 arena(1024);
+    const ArenaString empty;
+    const ArenaString hello(arena, "hello");
+    const ArenaString other(arena, "hello");
+
+    static_assert(sizeof(ArenaString) == sizeof(void*));
+    static_assert(std::is_trivially_copyable_v<ArenaString>);
+
+    EXPECT_EQ(empty.size(), 0);
+    EXPECT_STREQ(empty.c_str(), "");
+    EXPECT_EQ(hello.size(), 5);
+    EXPECT_STREQ(hello.c_str(), "hello");
+    EXPECT_EQ(hello, other);
+    EXPECT_NE(hello.data(), other.data());
+    EXPECT_EQ(std::string_view(hello), "hello");
+}
+
+TEST(ArenaStringTest, TestInternerDeduplicates) {
+    ArenaV2 arena(1 << 16);
+    ArenaInterner interner(arena, 4);
+
+    std::vector<ArenaString> first;
+    for (int i = 0; i < 1000; ++i) {
+        first.push_back(interner.intern("token" + std::to_string(i)));
+    }
+    EXPECT_EQ(interner.size(), 1000);
+    EXPECT_GE(interner.get_capacity() * 3, interner.size() * 4);
+
+    const size_t arena_size = arena.get_arena_size();
+    for (int i = 0; i < 1000; ++i) {
+        const ArenaString again = interner.intern("token" + std::to_string(i));
+        EXPECT_EQ(again.data(), first[i].data());
+    }
+    EXPECT_EQ(interner.size(), 1000);
+    EXPECT_EQ(arena.get_arena_size(), arena_size);
+}
+
+TEST(ArenaStringTest, TestInternerFind) {
+    ArenaV2 arena(1024);
+    ArenaInterner interner(arena);
+
+    EXPECT_FALSE(interner.contains(""));
+    const ArenaString empty = interner.intern("");
+    EXPECT_TRUE(interner.contains(""));
+    EXPECT_EQ(interner.find("").data(), empty.data());
+
+    const ArenaString word = interner.intern("word");
+    EXPECT_EQ(interner.find("word").data(), word.data());
+    EXPECT_FALSE(interner.contains("missing"));
+    EXPECT_TRUE(interner.find("missing").empty());
+    EXPECT_EQ(interner.size(), 2);
+}
+
+TEST(ArenaHashMapTest, TestInsertFindErase) {
+    ArenaV2 arena(1 << 16);
+    ArenaHashMap<int, int> map(arena);
+
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_TRUE(map.try_emplace(i, i * 2).second);
+    }
+    EXPECT_FALSE(map.try_emplace(5, 0).second);
+    EXPECT_EQ(map.size(), 10000);
+    EXPECT_LE(map.size() * 8, map.capacity() * 7);
+
+    for (int i = 0; i < 10000; i += 2) {
+        EXPECT_EQ(map.erase(i), 1);
+    }
+    EXPECT_EQ(map.erase(0), 0);
+    EXPECT_EQ(map.size(), 5000);
+
+    for (int i = 0; i < 10000; ++i) {
+        EXPECT_EQ(map.contains(i), i % 2 == 1);
+    }
+    EXPECT_EQ(map.at(7), 14);
+    EXPECT_THROW(map.at(8), std::out_of_range);
+    EXPECT_EQ(map.find(8), map.end());
+
+    map[8] = 3;
+    EXPECT_EQ(map.find(8)->second, 3);
+
+    long long sum = 0;
+    for (const auto& [key, value] : map) {
+        sum += value - 2 * key;
+    }
+    EXPECT_EQ(sum, 3 - 16);
+}
+
+TEST(ArenaHashMapTest, TestGrowsInPlace) {
+    ArenaV2 arena(1 << 20);
+    auto* before = static_cast<char*>(arena.allocate_raw(1, 1));
+    ArenaHashMap<int, int> map(arena);
+
+    for (int i = 0; i < 20000; ++i) {
+        map[i] = i;
+    }
+
+    // every growth extended the same table, so the arena holds just the one.
+    auto* after = static_cast<char*>(arena.allocate_raw(1, 1));
+    EXPECT_LE(static_cast<size_t>(after - before), 1 + alignof(int) + map.capacity() * (sizeof(std::pair<const int, int>) + 1));
+    for (int i = 0; i < 20000; ++i) {
+        ASSERT_EQ(map.at(i), i);
+    }
+}
+
+TEST(ArenaHashMapTest, TestRelocatesWhenNotLatest) {
+    ArenaV2 arena(1 << 12);
+    ArenaHashMap<std::string, int> map(arena);
+
+    for (int i = 0; i < 5000; ++i) {
+        map.try_emplace("key number " + std::to_string(i), i);
+        arena.allocate_raw(8, 8);
+    }
+
+    EXPECT_EQ(map.size(), 5000);
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(map.at("key number " + std::to_string(i)), i);
+    }
+}
+
+TEST(ArenaHashMapTest, TestOutlivingClearKeepsLiveAllocations) {
+    ArenaV2 arena(1 << 12);
+    char* start = static_cast<char*>(arena.allocate_raw(1, 1));
+    arena.deallocate_raw(start, 1);
+    char* live = nullptr;
+    size_t table_bytes = 0;
+    {
+        ArenaHashMap<int, int> map(arena);
+        map[1] = 1;
+        table_bytes = static_cast<size_t>(static_cast<char*>(arena.allocate_raw(1, 1)) - start);
+        arena.clear();
+
+        // the new cycle's bump pointer ends where the stale table does.
+        live = static_cast<char*>(arena.allocate_raw(table_bytes, 1));
+        ASSERT_EQ(live, start);
+    }
+    EXPECT_EQ(arena.allocate_raw(1, 1), live + table_bytes);
+}
+
+TEST(ArenaHashMapTest, TestChurnPurgesTombstones) {
+    ArenaV2 arena(1 << 16);
+    ArenaHashMap<int, TestStruct> map(arena);
+    TestStruct::destruct_count = 0;
+
+    for (int i = 0; i < 100000; ++i) {
+        map.try_emplace(i, i, i);
+        if (i >= 100) {
+            EXPECT_EQ(map.erase(i - 100), 1);
+        }
+    }
+
+    EXPECT_EQ(map.size(), 100);
+    EXPECT_LE(map.capacity(), 256);
+    for (int i = 100000 - 100; i < 100000; ++i) {
+        ASSERT_EQ(map.at(i).x, i);
+    }
+
+    const int destroyed = TestStruct::destruct_count;
+    map.clear();
+    EXPECT_EQ(TestStruct::destruct_count - destroyed, 100);
+    EXPECT_TRUE(map.empty());
+}
+
+struct ArenaTestTask {
+    struct promise_type : ArenaCoroutinePromise {
+        int value = 0;
+
+        ArenaTestTask get_return_object() {
+            return ArenaTestTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept {return {};}
+        std::suspend_always final_suspend() noexcept {return {};}
+        void return_value(const int v) noexcept {value = v;}
+        void unhandled_exception() {throw;}
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit ArenaTestTask(const std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    ArenaTestTask(ArenaTestTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    ~ArenaTestTask() { if (handle) handle.destroy(); }
+
+    int run() {
+        handle.resume();
+        return handle.promise().value;
+    }
+};
+
+static ArenaTestTask add_on_arena(ArenaV2&, const int a, const int b) {
+    co_return a + b;
+}
+
+static ArenaTestTask add_on_current(const int a, const int b) {
+    co_return a + b;
+}
+
+static ArenaTestTask add_after_scalar(const int& a, ArenaV2&, const int b) {
+    co_return a + b;
+}
+
+struct ArenaTestAdder {
+    int base;
+
+    ArenaTestTask add(ArenaV2&, const int x) const {
+        co_return base + x;
+    }
+};
+
+static bool allocated_between(const void* before, const void* ptr, const void* after) {
+    return std::less<>{}(before, ptr) && std::less<>{}(ptr, after);
+}
+
+TEST(ArenaCoroutineTest, TestLeadingArenaArgument) {
+    ArenaV2 arena(1 << 16);
+
+    const void* before = arena.allocate_raw(1, 1);
+    ArenaTestTask task = add_on_arena(arena, 2, 3);
+    const void* after = arena.allocate_raw(1, 1);
+    EXPECT_TRUE(allocated_between(before, task.handle.address(), after));
+    EXPECT_EQ(task.run(), 5);
+
+    const ArenaTestAdder adder{10};
+    const void* member_before = arena.allocate_raw(1, 1);
+    ArenaTestTask member = adder.add(arena, 7);
+    const void* member_after = arena.allocate_raw(1, 1);
+    EXPECT_TRUE(allocated_between(member_before, member.handle.address(), member_after));
+    EXPECT_EQ(member.run(), 17);
+
+    // an arena behind a leading scalar is not the leading-allocator convention, the frame goes to the heap.
+    const int a = 4;
+    const void* scalar_before = arena.allocate_raw(1, 1);
+    ArenaTestTask scalar = add_after_scalar(a, arena, 5);
+    EXPECT_EQ(arena.allocate_raw(1, 1), static_cast<const char*>(scalar_before) + 1);
+    EXPECT_EQ(scalar.run(), 9);
+}
+
+TEST(ArenaCoroutineTest, TestLatestFrameIsReclaimed) {
+    ArenaV2 arena(1 << 16);
+    void* first = nullptr;
+    {
+        ArenaTestTask task = add_on_arena(arena, 1, 1);
+        first = task.handle.address();
+        EXPECT_EQ(task.run(), 2);
+    }
+
+    for (int i = 0; i < 1000; ++i) {
+        ArenaTestTask task = add_on_arena(arena, i, 1);
+        ASSERT_EQ(task.handle.address(), first);
+        ASSERT_EQ(task.run(), i + 1);
+    }
+    EXPECT_EQ(arena.get_number_of_allocated_blocks(), 1);
+}
+
+TEST(ArenaCoroutineTest, TestCurrentArenaScope) {
+    EXPECT_EQ(ArenaCoroutinePromise::get_current_arena(), nullptr);
+
+    ArenaV2 outer(1 << 16);
+    ArenaV2 inner(1 << 16);
+    {
+        ArenaCoroutineScope outer_scope(outer);
+        {
+            ArenaCoroutineScope inner_scope(inner);
+            EXPECT_EQ(ArenaCoroutinePromise::get_current_arena(), &inner);
+
+            const void* before = inner.allocate_raw(1, 1);
+            ArenaTestTask task = add_on_current(4, 5);
+            const void* after = inner.allocate_raw(1, 1);
+            EXPECT_TRUE(allocated_between(before, task.handle.address(), after));
+            EXPECT_EQ(task.run(), 9);
+        }
+        EXPECT_EQ(ArenaCoroutinePromise::get_current_arena(), &outer);
+    }
+    EXPECT_EQ(ArenaCoroutinePromise::get_current_arena(), nullptr);
+
+    // without a current arena, frames come from the heap.
+    ArenaTestTask task = add_on_current(6, 7);
+    EXPECT_EQ(task.run(), 13);
+}
+
+TEST(ArenaProfileTest, TestTypeName) {
+    EXPECT_EQ(arena_type_name<int>(), "int");
+    EXPECT_EQ(arena_type_name<TestStruct>(), "TestStruct");
+    EXPECT_EQ(arena_type_name<std::vector<int>>().substr(0, 11), "std::vector");
+}
+
+TEST(ArenaProfileTest, TestSiteProfileAggregates) {
+    ArenaSiteProfile profile;
+    const std::source_location here = std::source_location::current();
+
+    profile.record(ArenaAllocationSample{24, 8, "Node", here, 4096});
+    profile.record(ArenaAllocationSample{24, 8, "Node", here, 4096});
+    profile.record(ArenaAllocationSample{1000, 8, "Node", here, 4096});
+    profile.record(ArenaAllocationSample{64, 16, {}, std::source_location{}, 2048});
+
+    const std::vector<ArenaSiteStats> sites = profile.get_sites();
+    ASSERT_EQ(sites.size(), 2);
+    EXPECT_EQ(sites[0].type_name, "Node");
+    EXPECT_EQ(sites[0].line, here.line());
+    EXPECT_EQ(sites[0].n_samples, 3);
+    EXPECT_EQ(sites[0].sampled_bytes, 3 * 4096);
+    EXPECT_EQ(sites[0].size_histogram[5], 2);
+    EXPECT_EQ(sites[0].size_histogram[10], 1);
+    EXPECT_TRUE(sites[1].type_name.empty());
+    EXPECT_EQ(sites[1].line, 0);
+
+    std::FILE* out = std::tmpfile();
+    ASSERT_NE(out, nullptr);
+    profile.write_report(out);
+    EXPECT_GT(std::ftell(out), 0);
+    std::fclose(out);
+
+    profile.reset();
+    EXPECT_TRUE(profile.get_sites().empty());
+}
+
+TEST(ArenaProfileTest, TestSamplesArenaAllocations) {
+    ArenaSiteProfile profile;
+    profile.install(1);
+    ArenaV2 arena(4096);
+
+    const std::source_location site = std::source_location::current();
+    for (int i = 0; i < 3; ++i) {
+        arena.create_at<TestStruct>(site, i, i);
+    }
+    arena.create<TestStruct>(1, 2);
+    arena.allocate_raw(100, 8);
+    ArenaProfiler::uninstall();
+    arena.allocate_raw(100, 8);
+
+    const std::vector<ArenaSiteStats> sites = profile.get_sites();
+    if constexpr (!ARENA_PROFILE) {
+        EXPECT_TRUE(sites.empty());
+        return;
+    }
+
+    ASSERT_EQ(sites.size(), 3);
+    const auto find = [&sites](const std::string_view type, const uint_least32_t line) {
+        return std::find_if(sites.begin(), sites.end(), [&](const ArenaSiteStats& s) {
+            return s.type_name == type && s.line == line;
+        });
+    };
+
+    const auto at_site = find("TestStruct", site.line());
+    ASSERT_NE(at_site, sites.end());
+    EXPECT_EQ(at_site->n_samples, 3);
+    EXPECT_EQ(at_site->sampled_bytes, 3 * sizeof(TestStruct));
+    EXPECT_EQ(at_site->function_name, site.function_name());
+
+    ASSERT_NE(find("TestStruct", 0), sites.end());
+    const auto raw = find("", 0);
+    ASSERT_NE(raw, sites.end());
+    EXPECT_EQ(raw->sampled_bytes, 100);
+}
+
+TEST(ArenaProfileTest, TestSampleIntervalCarriesSkippedBytes) {
+    ArenaSiteProfile profile;
+    profile.install(256);
+    ArenaV2 arena(1 << 16);
+
+    for (int i = 0; i < 100; ++i) {
+        arena.allocate_raw(64, 8);
+    }
+    ArenaProfiler::uninstall();
+
+    if constexpr (!ARENA_PROFILE) return;
+
+    const std::vector<ArenaSiteStats> sites = profile.get_sites();
+    ASSERT_EQ(sites.size(), 1);
+    EXPECT_EQ(sites[0].n_samples, 25);
+    EXPECT_EQ(sites[0].sampled_bytes, 100 * 64);
+}
+
+TEST(ArenaProfileTest, TestInstallRestartsSampling) {
+    ArenaV2 arena(1 << 16);
+    {
+        ArenaSiteProfile first;
+        first.install(256);
+        for (int i = 0; i < 3; ++i) {
+            arena.allocate_raw(64, 8);
+        }
+        ArenaProfiler::uninstall();
+        EXPECT_TRUE(first.get_sites().empty());
+    }
+
+    // the 192 bytes counted for the first profile do not carry over.
+    ArenaSiteProfile second;
+    second.install(256);
+    arena.allocate_raw(64, 8);
+    EXPECT_TRUE(second.get_sites().empty());
+
+    for (int i = 0; i < 3; ++i) {
+        arena.allocate_raw(64, 8);
+    }
+    ArenaProfiler::uninstall();
+
+    if constexpr (!ARENA_PROFILE) return;
+
+    const std::vector<ArenaSiteStats> sites = second.get_sites();
+    ASSERT_EQ(sites.size(), 1);
+    EXPECT_EQ(sites[0].sampled_bytes, 256);
+}
+
+TEST(ObjectArenaTest, TestIteratesInAllocationOrder) {
+    ObjectArena<TestStruct> arena(10 * sizeof(TestStruct));
+    EXPECT_TRUE(arena.empty());
+    EXPECT_EQ(arena.begin(), arena.end());
+
+    for (int i = 0; i < 95; ++i) {
+        TestStruct* obj = arena.create(i, -i);
+        ASSERT_EQ(obj->x, i);
+    }
+    EXPECT_EQ(arena.size(), 95);
+    EXPECT_EQ(arena.get_number_of_slabs(), 10);
+
+    int expected = 0;
+    for (const TestStruct& obj : arena) {
+        ASSERT_EQ(obj.x, expected++);
+    }
+    EXPECT_EQ(expected, 95);
+
+    expected = 0;
+    std::as_const(arena).for_each([&expected](const TestStruct& obj) {
+        EXPECT_EQ(obj.y, -expected++);
+    });
+    EXPECT_EQ(expected, 95);
+}
+
+TEST(ObjectArenaTest, TestClearDestroysInReverseAndReusesSlabs) {
+    static std::vector<int> order;
+    struct Tracked {
+        int id;
+        explicit Tracked(const int id) : id(id) {}
+        ~Tracked() { order.push_back(id); }
+    };
+
+    ObjectArena<Tracked> arena(4 * sizeof(Tracked));
+    for (int i = 0; i < 10; ++i) {
+        arena.create(i);
+    }
+    const size_t slabs = arena.get_number_of_slabs();
+
+    order.clear();
+    arena.clear();
+    EXPECT_EQ(order, (std::vector<int>{9, 8, 7, 6, 5, 4, 3, 2, 1, 0}));
+    EXPECT_TRUE(arena.empty());
+
+    for (int i = 0; i < 10; ++i) {
+        arena.create(i);
+    }
+    EXPECT_EQ(arena.get_number_of_slabs(), slabs);
+
+    order.clear();
+    {
+        ObjectArena<Tracked> moved(std::move(arena));
+        EXPECT_EQ(moved.size(), 10);
+        EXPECT_EQ(arena.size(), 0);
+    }
+    EXPECT_EQ(order.size(), 10);
+}
+
+TEST(ObjectArenaTest, TestOverAlignedAndGrowth) {
+    struct alignas(64) Wide {
+        int value;
+    };
+
+    ObjectArena<Wide> arena(ArenaOptions{.block_size = 100, .growth = ArenaGrowthPolicy::geometric(2.0, 4096)});
+    for (int i = 0; i < 200; ++i) {
+        const Wide* obj = arena.create(Wide{i});
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(obj) % 64, 0);
+    }
+    EXPECT_LT(arena.get_number_of_slabs(), 10);
+
+    int sum = 0;
+    arena.for_each([&sum](const Wide& w) { sum += w.value; });
+    EXPECT_EQ(sum, 199 * 200 / 2);
+}
+
+TEST(ObjectArenaTest, TestLeakDestructors) {
+    TestStruct::destruct_count = 0;
+    {
+        ObjectArena<TestStruct> arena(ArenaOptions{.block_size = 256, .leak_destructors = true});
+        for (int i = 0; i < 20; ++i) {
+            arena.create(i, i);
+        }
+        arena.clear();
+    }
+    EXPECT_EQ(TestStruct::destruct_count, 0);
+}